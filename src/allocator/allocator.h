@@ -0,0 +1,226 @@
+#ifndef ALLOCATOR_H
+#define ALLOCATOR_H
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+/*
+ * Allocator policies for Stack, Queue and PriorityQueue.
+ * A policy is a small copyable handle with
+ *     void* allocate(size_t bytes, size_t align)
+ *     void deallocate(void* p, size_t bytes, size_t align)
+ *     static constexpr bool releases_in_bulk
+ *     operator==, true if either handle may free the other's memory
+ * Containers store the handle by value, so HeapAllocator costs nothing.
+ * None of the resources below are thread-safe
+ */
+
+// Plain global new/delete, the default
+struct HeapAllocator {
+    static constexpr bool releases_in_bulk = false;
+
+    [[nodiscard]] void* allocate(const size_t bytes, const size_t align) const {
+        if (align > __STDCPP_DEFAULT_NEW_ALIGNMENT__) return ::operator new(bytes, std::align_val_t(align));
+        return ::operator new(bytes);
+    }
+
+    void deallocate(void* p, const size_t bytes, const size_t align) const noexcept {
+        if (align > __STDCPP_DEFAULT_NEW_ALIGNMENT__) ::operator delete(p, bytes, std::align_val_t(align));
+        else ::operator delete(p, bytes);
+    }
+
+    friend bool operator==(const HeapAllocator&, const HeapAllocator&) { return true; }
+};
+
+/*
+ * Monotonic buffer: carves requests out of big chunks
+ * and frees nothing until release(), which drops every chunk at once.
+ * Any number of containers may share one arena
+ */
+class Arena {
+    private:
+    struct Chunk {
+        Chunk* prev;
+        size_t bytes;
+    };
+
+    static constexpr size_t default_chunk_bytes = 64 * 1024;
+
+    Chunk* chunks;
+    unsigned char* cursor;
+    unsigned char* end;
+    size_t chunk_bytes;
+    size_t used_bytes;
+
+    void add_chunk(const size_t min_bytes) {
+        size_t bytes = chunk_bytes;
+        while (bytes < min_bytes + sizeof(Chunk)) bytes *= 2;
+        auto chunk = static_cast<Chunk*>(::operator new(bytes));
+        chunk->prev = chunks;
+        chunk->bytes = bytes;
+        chunks = chunk;
+        cursor = reinterpret_cast<unsigned char*>(chunk + 1);
+        end = reinterpret_cast<unsigned char*>(chunk) + bytes;
+    }
+
+    public:
+    explicit Arena(const size_t chunk_size = default_chunk_bytes)
+        : chunks(nullptr), cursor(nullptr), end(nullptr),
+          chunk_bytes(chunk_size > sizeof(Chunk) ? chunk_size : default_chunk_bytes), used_bytes(0) {}
+    ~Arena() { release(); }
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    Arena(Arena&&) = delete;
+    Arena& operator=(Arena&&) = delete;
+
+    [[nodiscard]] void* allocate(const size_t bytes, const size_t align) {
+        auto aligned = [&] {
+            const auto addr = reinterpret_cast<uintptr_t>(cursor);
+            return reinterpret_cast<unsigned char*>((addr + align - 1) & ~(uintptr_t(align) - 1));
+        };
+        unsigned char* p = cursor ? aligned() : nullptr;
+        if (p == nullptr || p + bytes > end) {
+            add_chunk(bytes + align);
+            p = aligned();
+        }
+        cursor = p + bytes;
+        used_bytes += bytes;
+        return p;
+    }
+
+    // Free every chunk in one pass, memory handed out before is invalid afterwards
+    void release() noexcept {
+        while (chunks != nullptr) {
+            Chunk* prev = chunks->prev;
+            ::operator delete(chunks, chunks->bytes);
+            chunks = prev;
+        }
+        cursor = nullptr;
+        end = nullptr;
+        used_bytes = 0;
+    }
+
+    [[nodiscard]] size_t get_used_bytes() const { return used_bytes; }
+};
+
+/*
+ * Free-list pool on top of an arena.
+ * Freed blocks go to a list per (size, alignment) and are handed out
+ * again before new arena space is touched. Containers only ask for a few
+ * distinct sizes (stack blocks, doubling buffers), so the class list stays short.
+ * Containers using the pool must be gone before release() or the destructor
+ */
+class Pool {
+    private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    struct SizeClass {
+        size_t bytes;
+        size_t align;
+        FreeBlock* free;
+        SizeClass* next;
+    };
+
+    Arena arena;
+    SizeClass* classes;
+    size_t live_blocks; // handed out and not deallocated yet
+
+    SizeClass* find_class(const size_t bytes, const size_t align) {
+        for (auto c = classes; c != nullptr; c = c->next) {
+            if (c->bytes == bytes && c->align == align) return c;
+        }
+        auto c = static_cast<SizeClass*>(arena.allocate(sizeof(SizeClass), alignof(SizeClass)));
+        *c = SizeClass{bytes, align, nullptr, classes};
+        classes = c;
+        return c;
+    }
+
+    static size_t block_bytes(const size_t bytes) {
+        return bytes < sizeof(FreeBlock) ? sizeof(FreeBlock) : bytes;
+    }
+
+    static size_t block_align(const size_t align) {
+        return align < alignof(FreeBlock) ? alignof(FreeBlock) : align;
+    }
+
+    public:
+    explicit Pool(const size_t chunk_size = 64 * 1024) : arena(chunk_size), classes(nullptr), live_blocks(0) {}
+    ~Pool() { release(); }
+
+    Pool(const Pool&) = delete;
+    Pool& operator=(const Pool&) = delete;
+    Pool(Pool&&) = delete;
+    Pool& operator=(Pool&&) = delete;
+
+    [[nodiscard]] void* allocate(const size_t bytes, const size_t align) {
+        SizeClass* c = find_class(block_bytes(bytes), block_align(align));
+        void* res;
+        if (c->free != nullptr) {
+            FreeBlock* block = c->free;
+            c->free = block->next;
+            res = block;
+        } else {
+            res = arena.allocate(c->bytes, c->align);
+        }
+        ++live_blocks;
+        return res;
+    }
+
+    void deallocate(void* p, const size_t bytes, const size_t align) noexcept {
+        // The class exists: p was handed out by allocate with the same size
+        SizeClass* c = classes;
+        while (c->bytes != block_bytes(bytes) || c->align != block_align(align)) c = c->next;
+        auto block = static_cast<FreeBlock*>(p);
+        block->next = c->free;
+        c->free = block;
+        --live_blocks;
+    }
+
+    // Drop every block at once. Every block must have been deallocated:
+    // a container still holding one would free it into a class list that is gone
+    void release() noexcept {
+        assert(live_blocks == 0 && "Pool released while containers still use it");
+        arena.release();
+        classes = nullptr;
+        live_blocks = 0;
+    }
+
+    [[nodiscard]] size_t get_live_blocks() const { return live_blocks; }
+
+    [[nodiscard]] size_t get_used_bytes() const { return arena.get_used_bytes(); }
+};
+
+// Handle types used as the Alloc template argument
+
+struct PoolAllocator {
+    static constexpr bool releases_in_bulk = false;
+    Pool* pool;
+
+    explicit PoolAllocator(Pool& p) : pool(&p) {}
+
+    [[nodiscard]] void* allocate(const size_t bytes, const size_t align) const { return pool->allocate(bytes, align); }
+    void deallocate(void* p, const size_t bytes, const size_t align) const noexcept { pool->deallocate(p, bytes, align); }
+
+    // Memory from one handle may be freed through another with the same pool
+    friend bool operator==(const PoolAllocator&, const PoolAllocator&) = default;
+};
+
+// Deallocation is a no-op: containers over trivially destructible
+// elements skip their destructor loops and leave cleanup to Arena::release
+struct ArenaAllocator {
+    static constexpr bool releases_in_bulk = true;
+    Arena* arena;
+
+    explicit ArenaAllocator(Arena& a) : arena(&a) {}
+
+    [[nodiscard]] void* allocate(const size_t bytes, const size_t align) const { return arena->allocate(bytes, align); }
+    void deallocate(void*, size_t, size_t) const noexcept {}
+
+    friend bool operator==(const ArenaAllocator&, const ArenaAllocator&) = default;
+};
+
+#endif //ALLOCATOR_H
@@ -0,0 +1,112 @@
+#include <cassert>
+#include <iostream>
+#include <string>
+#include "allocator/allocator.h"
+#include "priority_q/priority_q.h"
+#include "queue/queue.h"
+#include "stack/stack.h"
+#include "test_allocator.h"
+
+namespace {
+    constexpr int NUM_ELEMENTS = 1000;
+
+    void fill(Stack<std::string, PoolAllocator>& s, const int n) {
+        for (int i = 0; i < n; ++i) s.push(std::to_string(i));
+    }
+
+    void fill(Queue<std::string, PoolAllocator>& q, const int n) {
+        for (int i = 0; i < n; ++i) q.push(std::to_string(i));
+    }
+
+    void fill(PriorityQueue<std::string, 2, PoolAllocator>& pq, const int n) {
+        for (int i = 0; i < n; ++i) pq.push(std::to_string(i), i);
+    }
+
+    // A second container of the same shape runs entirely on blocks the first gave back
+    template<typename C>
+    void check_reuse(Pool& pool, [[maybe_unused]] const std::string& expected_first) {
+        {
+            C first{PoolAllocator(pool)};
+            fill(first, NUM_ELEMENTS);
+            assert(first.get_size() == static_cast<size_t>(NUM_ELEMENTS));
+        }
+        assert(pool.get_live_blocks() == 0);
+        [[maybe_unused]] const size_t used = pool.get_used_bytes();
+        assert(used > 0);
+        {
+            C second{PoolAllocator(pool)};
+            fill(second, NUM_ELEMENTS);
+            assert(pool.get_used_bytes() == used);
+            [[maybe_unused]] const std::string first_out = second.pop();
+            assert(first_out == expected_first);
+        }
+        assert(pool.get_live_blocks() == 0);
+    }
+}
+
+void run_tests_allocator() {
+    std::cout << "=== Running Allocator Tests ===" << std::endl;
+
+    // Test 1: A freed block is the next one handed out for its size
+    std::cout << "Test 1: Free list reuse... ";
+    Pool pool;
+    void* a = pool.allocate(48, 8);
+    void* b = pool.allocate(48, 8);
+    void* other = pool.allocate(200, 16);
+    assert(a != b);
+    assert(pool.get_live_blocks() == 3);
+    [[maybe_unused]] const size_t used = pool.get_used_bytes();
+    pool.deallocate(a, 48, 8);
+    pool.deallocate(b, 48, 8);
+    void* again_b = pool.allocate(48, 8);
+    void* again_a = pool.allocate(48, 8);
+    assert(again_b == b);  // LIFO: the last freed comes back first
+    assert(again_a == a);
+    assert(pool.get_used_bytes() == used);
+    void* fresh = pool.allocate(48, 8);  // List is empty, new arena space
+    assert(fresh != a && fresh != b);
+    assert(pool.get_used_bytes() > used);
+    pool.deallocate(other, 200, 16);
+    void* again_other = pool.allocate(200, 16);
+    assert(again_other == other);  // Classes keep separate lists
+    pool.deallocate(again_other, 200, 16);
+    pool.deallocate(fresh, 48, 8);
+    pool.deallocate(again_a, 48, 8);
+    pool.deallocate(again_b, 48, 8);
+    assert(pool.get_live_blocks() == 0);
+    pool.release();
+    assert(pool.get_used_bytes() == 0);
+    std::cout << "PASSED" << std::endl;
+
+    // Test 2: Containers give their blocks back and the next container reuses them
+    std::cout << "Test 2: Containers over a pool... ";
+    Pool stacks, queues, heaps;
+    const std::string last = std::to_string(NUM_ELEMENTS - 1);
+    check_reuse<Stack<std::string, PoolAllocator>>(stacks, last);
+    check_reuse<Queue<std::string, PoolAllocator>>(queues, "0");
+    check_reuse<PriorityQueue<std::string, 2, PoolAllocator>>(heaps, last);
+    std::cout << "PASSED" << std::endl;
+
+    // Test 3: Several containers share one arena, release frees them all at once
+    std::cout << "Test 3: Shared arena... ";
+    Arena arena;
+    {
+        Stack<int, ArenaAllocator> s{ArenaAllocator(arena)};
+        Queue<int, ArenaAllocator> q{ArenaAllocator(arena)};
+        QuaternaryPriorityQueue<int, ArenaAllocator> pq{ArenaAllocator(arena)};
+        for (int i = 0; i < NUM_ELEMENTS; ++i) {
+            s.push(i);
+            q.push(-i);
+            pq.push(i, i);
+        }
+        assert(s.peek() == NUM_ELEMENTS - 1);
+        assert(q.peek_head() == 0);
+        assert(pq.top() == NUM_ELEMENTS - 1);
+    }
+    assert(arena.get_used_bytes() > 0);
+    arena.release();
+    assert(arena.get_used_bytes() == 0);
+    std::cout << "PASSED" << std::endl;
+
+    std::cout << "\n=== All Allocator tests PASSED! ===" << std::endl;
+}
@@ -0,0 +1,6 @@
+#ifndef TEST_ALLOCATOR_H
+#define TEST_ALLOCATOR_H
+
+void run_tests_allocator();
+
+#endif //TEST_ALLOCATOR_H
@@ -0,0 +1,44 @@
+#ifndef BENCH_H
+#define BENCH_H
+#include <chrono>
+#include <cstddef>
+
+/*
+ * Benchmarks are plain functions, one per suite,
+ * called from bench_main.cpp by name.
+ * Suites that produce comparable numbers report them as Rows;
+ * bench_main.cpp prints them as a table and writes CSV/JSON on request
+ */
+
+namespace Bench {
+    using Clock = std::chrono::steady_clock;
+
+    inline double seconds_since(const Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    struct Options {
+        size_t max_size = 10000000; // largest container size a suite should try
+    };
+
+    struct Row {
+        const char* container;
+        const char* element;
+        const char* pattern;
+        const char* op;
+        size_t size;
+        size_t ops;
+        double mops;   // throughput, millions of ops per second
+        double p50_ns; // per-op latency percentiles
+        double p99_ns;
+    };
+
+    const Options& options();
+    void report(const Row& row);
+
+    void run_containers();
+    void run_indexed_pq();
+    void run_multi_queue();
+}
+
+#endif //BENCH_H
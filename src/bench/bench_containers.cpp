@@ -0,0 +1,327 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <queue>
+#include <stack>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bench.h"
+#include "priority_q/priority_q.h"
+#include "queue/queue.h"
+#include "stack/stack.h"
+
+/*
+ * Stack, Queue and PriorityQueue against std::stack, std::queue and
+ * std::priority_queue, for every element type, size and access pattern:
+ *     burst  - fill to size, peek, miss-find (full scan), drain
+ *     churn  - hold size elements, pop one push one
+ *     random - PriorityQueue only: burst with random priorities
+ * (burst pushes ascending priorities, each new element is the new top).
+ * Every scenario runs twice: once untimed per op for throughput, once
+ * timing a strided sample of single ops for p50/p99. Latencies have the
+ * clock's own cost subtracted
+ */
+
+namespace {
+    constexpr size_t SIZES[] = {1000, 10000, 100000, 1000000, 10000000};
+    constexpr size_t POOL = 4096; // distinct values pushed round-robin
+    constexpr size_t MAX_SAMPLES = 100000;
+    constexpr size_t FIND_BUDGET = 20000000; // elements scanned per find phase
+
+    struct LargePod {
+        uint64_t key;
+        unsigned char payload[56];
+
+        bool operator==(const LargePod& other) const { return key == other.key; }
+    };
+
+    volatile size_t sink;
+
+    // == Element types ==
+    template<typename E>
+    E make_value(size_t i);
+
+    template<>
+    int make_value<int>(const size_t i) { return static_cast<int>(i); }
+
+    template<>
+    double make_value<double>(const size_t i) { return static_cast<double>(i) * 0.5; }
+
+    template<>
+    std::string make_value<std::string>(const size_t i) { return "value " + std::to_string(i); }
+
+    template<>
+    LargePod make_value<LargePod>(const size_t i) {
+        LargePod pod{};
+        pod.key = i;
+        return pod;
+    }
+
+    void consume(const int v) { sink = sink + static_cast<size_t>(v); }
+    void consume(const double v) { sink = sink + static_cast<size_t>(v); }
+    void consume(const std::string& v) { sink = sink + v.size(); }
+    void consume(const LargePod& v) { sink = sink + v.key; }
+
+    // == Adapters: one interface over both sides ==
+    template<typename E>
+    struct LabStack {
+        static constexpr const char* name = "Stack";
+        Stack<E> s;
+        void push(const E& e, int) { s.push(e); }
+        E pop() { return s.pop(); }
+        const E& peek() const { return s.peek(); }
+        bool find(const E& e) const { return std::find(s.begin(), s.end(), e) != s.end(); }
+    };
+
+    // std adapters expose their protected container c for find
+    template<typename E>
+    struct StdStack : std::stack<E> {
+        static constexpr const char* name = "std::stack";
+        void push(const E& e, int) { std::stack<E>::push(e); }
+        E pop() {
+            E res = std::move(this->top());
+            std::stack<E>::pop();
+            return res;
+        }
+        const E& peek() const { return this->top(); }
+        bool find(const E& e) const { return std::find(this->c.begin(), this->c.end(), e) != this->c.end(); }
+    };
+
+    template<typename E>
+    struct LabQueue {
+        static constexpr const char* name = "Queue";
+        Queue<E> q;
+        void push(const E& e, int) { q.push(e); }
+        E pop() { return q.pop(); }
+        const E& peek() const { return q.peek_head(); }
+        bool find(const E& e) const { return std::find(q.begin(), q.end(), e) != q.end(); }
+    };
+
+    template<typename E>
+    struct StdQueue : std::queue<E> {
+        static constexpr const char* name = "std::queue";
+        void push(const E& e, int) { std::queue<E>::push(e); }
+        E pop() {
+            E res = std::move(this->front());
+            std::queue<E>::pop();
+            return res;
+        }
+        const E& peek() const { return this->front(); }
+        bool find(const E& e) const { return std::find(this->c.begin(), this->c.end(), e) != this->c.end(); }
+    };
+
+    template<typename E>
+    struct LabPriorityQueue {
+        static constexpr const char* name = "PriorityQueue";
+        PriorityQueue<E> pq;
+        void push(const E& e, const int priority) { pq.push(e, priority); }
+        E pop() { return pq.pop(); }
+        const E& peek() const { return pq.top(); }
+        bool find(const E& e) const { return pq.find_by_value(e) != -1; }
+    };
+
+    // Same contract as PriorityQueue: highest priority first, FIFO within one
+    template<typename E>
+    struct StdItem {
+        int priority;
+        uint64_t seq;
+        E data;
+
+        bool operator<(const StdItem& other) const {
+            return priority != other.priority ? priority < other.priority : seq > other.seq;
+        }
+    };
+
+    template<typename E>
+    struct StdPriorityQueue : std::priority_queue<StdItem<E>> {
+        static constexpr const char* name = "std::priority_queue";
+        uint64_t next_seq = 0;
+        void push(const E& e, const int priority) {
+            std::priority_queue<StdItem<E>>::push(StdItem<E>{priority, next_seq++, e});
+        }
+        // top() is const, the element is copied out as user code has to
+        E pop() {
+            E res = this->top().data;
+            std::priority_queue<StdItem<E>>::pop();
+            return res;
+        }
+        const E& peek() const { return this->top().data; }
+        bool find(const E& e) const {
+            return std::find_if(this->c.begin(), this->c.end(), [&e](const StdItem<E>& item) {
+                return item.data == e;
+            }) != this->c.end();
+        }
+    };
+
+    // == Measurement ==
+    struct Plain {
+        template<typename F>
+        void operator()(size_t, F&& f) { f(); }
+    };
+
+    struct Sampled {
+        std::vector<double>& samples;
+        size_t stride;
+
+        template<typename F>
+        void operator()(const size_t i, F&& f) {
+            if (i % stride != 0) {
+                f();
+                return;
+            }
+            const auto start = Bench::Clock::now();
+            f();
+            samples.push_back(std::chrono::duration<double, std::nano>(Bench::Clock::now() - start).count());
+        }
+    };
+
+    double clock_overhead_ns() {
+        static const double overhead = [] {
+            std::vector<double> samples;
+            Sampled probe{samples, 1};
+            for (size_t i = 0; i < 10000; ++i) probe(i, [] {});
+            std::sort(samples.begin(), samples.end());
+            return samples[samples.size() / 2];
+        }();
+        return overhead;
+    }
+
+    struct Phase {
+        const char* op;
+        size_t ops;
+        double seconds;
+        std::vector<double> samples;
+    };
+
+    // First pass records ops and time per phase, the second pass fills in samples
+    class Recorder {
+        private:
+        std::vector<Phase>& phases;
+        bool sampling;
+        size_t next;
+
+        public:
+        Recorder(std::vector<Phase>& p, const bool sample) : phases(p), sampling(sample), next(0) {}
+
+        template<typename Body>
+        void operator()(const char* op, const size_t ops, Body body) {
+            if (!sampling) {
+                Plain probe;
+                const auto start = Bench::Clock::now();
+                body(probe);
+                phases.push_back(Phase{op, ops, Bench::seconds_since(start), {}});
+                return;
+            }
+            Phase& phase = phases[next++];
+            phase.samples.reserve(MAX_SAMPLES + 1);
+            Sampled probe{phase.samples, ops > MAX_SAMPLES ? ops / MAX_SAMPLES : 1};
+            body(probe);
+        }
+    };
+
+    enum class Pattern { BURST, CHURN, RANDOM };
+
+    const char* pattern_name(const Pattern p) {
+        switch (p) {
+            case Pattern::BURST: return "burst";
+            case Pattern::CHURN: return "churn";
+            case Pattern::RANDOM: return "random";
+        }
+        return "?";
+    }
+
+    struct Priorities {
+        Pattern pattern;
+        unsigned seed = 12345;
+
+        int operator()(const size_t i) {
+            if (pattern == Pattern::BURST) return static_cast<int>(i);
+            seed = seed * 1103515245u + 12345u;
+            return static_cast<int>((seed >> 8) % 1000000);
+        }
+    };
+
+    template<typename Q, typename E>
+    void scenario(Recorder& record, const Pattern pattern, const size_t n, const std::vector<E>& pool) {
+        Q q;
+        Priorities priority{pattern};
+        if (pattern == Pattern::CHURN) {
+            for (size_t i = 0; i < n; ++i) q.push(pool[i % POOL], priority(i));
+            record("pop_push", n, [&](auto& probe) {
+                for (size_t i = 0; i < n; ++i) {
+                    probe(i, [&] {
+                        consume(q.pop());
+                        q.push(pool[i % POOL], priority(i));
+                    });
+                }
+            });
+            return;
+        }
+
+        record("push", n, [&](auto& probe) {
+            for (size_t i = 0; i < n; ++i) probe(i, [&] { q.push(pool[i % POOL], priority(i)); });
+        });
+        record("peek", n, [&](auto& probe) {
+            for (size_t i = 0; i < n; ++i) probe(i, [&] { consume(q.peek()); });
+        });
+        const size_t finds = std::max<size_t>(1, std::min<size_t>(1000, FIND_BUDGET / n));
+        const E missing = make_value<E>(POOL + 1);
+        record("find", finds, [&](auto& probe) {
+            for (size_t i = 0; i < finds; ++i) probe(i, [&] { sink = sink + q.find(missing); });
+        });
+        record("pop", n, [&](auto& probe) {
+            for (size_t i = 0; i < n; ++i) probe(i, [&] { consume(q.pop()); });
+        });
+    }
+
+    double percentile(std::vector<double>& samples, const double p) {
+        if (samples.empty()) return 0;
+        const size_t k = std::min(samples.size() - 1, static_cast<size_t>(p * static_cast<double>(samples.size())));
+        std::nth_element(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(k), samples.end());
+        return std::max(0.0, samples[k] - clock_overhead_ns());
+    }
+
+    template<typename Q, typename E>
+    void measure(const char* element, const Pattern pattern, const size_t n, const std::vector<E>& pool) {
+        std::vector<Phase> phases;
+        Recorder plain(phases, false);
+        scenario<Q>(plain, pattern, n, pool);
+        Recorder sampled(phases, true);
+        scenario<Q>(sampled, pattern, n, pool);
+        for (Phase& phase : phases) {
+            Bench::report(Bench::Row{Q::name, element, pattern_name(pattern), phase.op, n, phase.ops,
+                                     static_cast<double>(phase.ops) / phase.seconds / 1e6,
+                                     percentile(phase.samples, 0.50), percentile(phase.samples, 0.99)});
+        }
+    }
+
+    template<typename E>
+    void run_element(const char* element) {
+        std::vector<E> pool;
+        pool.reserve(POOL);
+        for (size_t i = 0; i < POOL; ++i) pool.push_back(make_value<E>(i));
+
+        for (const size_t n : SIZES) {
+            if (n > Bench::options().max_size) break;
+            for (const Pattern pattern : {Pattern::BURST, Pattern::CHURN}) {
+                measure<LabStack<E>>(element, pattern, n, pool);
+                measure<StdStack<E>>(element, pattern, n, pool);
+                measure<LabQueue<E>>(element, pattern, n, pool);
+                measure<StdQueue<E>>(element, pattern, n, pool);
+            }
+            for (const Pattern pattern : {Pattern::BURST, Pattern::CHURN, Pattern::RANDOM}) {
+                measure<LabPriorityQueue<E>>(element, pattern, n, pool);
+                measure<StdPriorityQueue<E>>(element, pattern, n, pool);
+            }
+        }
+    }
+}
+
+void Bench::run_containers() {
+    run_element<int>("int");
+    run_element<double>("double");
+    run_element<std::string>("string");
+    run_element<LargePod>("pod64");
+}
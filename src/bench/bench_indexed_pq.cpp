@@ -0,0 +1,58 @@
+#include <iomanip>
+#include <iostream>
+
+#include "bench.h"
+#include "priority_q/priority_q.h"
+
+namespace {
+    constexpr int SIZES[] = {1000, 10000, 100000};
+    constexpr int LOOKUPS = 2000;
+
+    struct Result {
+        double push_pop_mops;
+        double lookup_us;
+    };
+
+    template<typename Q>
+    Result measure(const int n) {
+        Q queue;
+        unsigned seed = 12345;
+        volatile long long sink = 0;
+
+        // Push/pop churn: the index has to follow every change
+        const auto start = Bench::Clock::now();
+        for (int i = 0; i < n; ++i) {
+            seed = seed * 1103515245u + 12345u;
+            queue.push(i, static_cast<int>((seed >> 8) % 1000));
+        }
+        for (int i = 0; i < n; ++i) {
+            seed = seed * 1103515245u + 12345u;
+            sink = sink + queue.pop();
+            queue.push(i, static_cast<int>((seed >> 8) % 1000));
+        }
+        const double churn = Bench::seconds_since(start);
+
+        const auto lookup_start = Bench::Clock::now();
+        for (int i = 0; i < LOOKUPS; ++i) {
+            sink = sink + queue.find_by_value(i * 7 % n);
+            sink = sink + queue.contains_by_priority(i % 1000);
+        }
+        const double lookups = Bench::seconds_since(lookup_start);
+
+        return Result{3.0 * n / churn / 1e6, lookups / LOOKUPS * 1e6};
+    }
+}
+
+void Bench::run_indexed_pq() {
+    std::cout << "=== PriorityQueue: linear scans vs HashIndex ===" << std::endl;
+    std::cout << std::setw(10) << "size"
+              << std::setw(18) << "plain Mops/s" << std::setw(18) << "indexed Mops/s"
+              << std::setw(18) << "plain lookup us" << std::setw(18) << "indexed lookup us" << std::endl;
+    for (const int n : SIZES) {
+        const Result plain = measure<PriorityQueue<int>>(n);
+        const Result indexed = measure<IndexedPriorityQueue<int>>(n);
+        std::cout << std::setw(10) << n << std::fixed << std::setprecision(3)
+                  << std::setw(18) << plain.push_pop_mops << std::setw(18) << indexed.push_pop_mops
+                  << std::setw(18) << plain.lookup_us << std::setw(18) << indexed.lookup_us << std::endl;
+    }
+}
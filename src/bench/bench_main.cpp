@@ -0,0 +1,148 @@
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "bench.h"
+
+namespace {
+    struct Suite {
+        const char* name;
+        void (*run)();
+    };
+
+    constexpr Suite suites[] = {
+        {"containers", Bench::run_containers},
+        {"indexed_pq", Bench::run_indexed_pq},
+        {"multi_queue", Bench::run_multi_queue},
+    };
+
+    Bench::Options opts;
+
+    // Rows go to stdout as a table, and to CSV/JSON sinks when asked for.
+    // "-" as a file name sends that format to stdout instead of the table
+    class Reporter {
+        private:
+        std::unique_ptr<std::ofstream> csv_file;
+        std::unique_ptr<std::ofstream> json_file;
+        std::ostream* csv = nullptr;
+        std::ostream* json = nullptr;
+        bool table = true;
+        bool table_header = false;
+        size_t json_rows = 0;
+
+        static std::ostream* open(const char* path, std::unique_ptr<std::ofstream>& file) {
+            if (std::strcmp(path, "-") == 0) return &std::cout;
+            file = std::make_unique<std::ofstream>(path);
+            if (!*file) {
+                std::cerr << "Cannot open " << path << std::endl;
+                std::exit(1);
+            }
+            return file.get();
+        }
+
+        public:
+        void set_csv(const char* path) {
+            csv = open(path, csv_file);
+            if (csv == &std::cout) table = false;
+            *csv << "container,element,pattern,op,size,ops,mops,p50_ns,p99_ns\n";
+        }
+
+        void set_json(const char* path) {
+            json = open(path, json_file);
+            if (json == &std::cout) table = false;
+            *json << "[";
+        }
+
+        void row(const Bench::Row& r) {
+            if (table) {
+                if (!table_header) {
+                    std::cout << std::left << std::setw(22) << "container" << std::setw(10) << "element"
+                              << std::setw(8) << "pattern" << std::setw(10) << "op" << std::right
+                              << std::setw(10) << "size" << std::setw(12) << "Mops/s"
+                              << std::setw(10) << "p50 ns" << std::setw(10) << "p99 ns" << std::endl;
+                    table_header = true;
+                }
+                std::cout << std::left << std::setw(22) << r.container << std::setw(10) << r.element
+                          << std::setw(8) << r.pattern << std::setw(10) << r.op << std::right
+                          << std::setw(10) << r.size << std::fixed << std::setprecision(3)
+                          << std::setw(12) << r.mops << std::setprecision(0)
+                          << std::setw(10) << r.p50_ns << std::setw(10) << r.p99_ns << std::endl;
+            }
+            if (csv != nullptr) {
+                *csv << r.container << ',' << r.element << ',' << r.pattern << ',' << r.op << ','
+                     << r.size << ',' << r.ops << ',' << r.mops << ',' << r.p50_ns << ',' << r.p99_ns << '\n';
+            }
+            if (json != nullptr) {
+                *json << (json_rows++ == 0 ? "\n" : ",\n")
+                      << "  {\"container\": \"" << r.container << "\", \"element\": \"" << r.element
+                      << "\", \"pattern\": \"" << r.pattern << "\", \"op\": \"" << r.op
+                      << "\", \"size\": " << r.size << ", \"ops\": " << r.ops << ", \"mops\": " << r.mops
+                      << ", \"p50_ns\": " << r.p50_ns << ", \"p99_ns\": " << r.p99_ns << "}";
+            }
+        }
+
+        void finish() {
+            if (csv != nullptr) csv->flush();
+            if (json != nullptr) *json << "\n]\n" << std::flush;
+        }
+    };
+
+    Reporter reporter;
+
+    bool starts_with(const char* arg, const char* prefix, const char*& value) {
+        const size_t n = std::strlen(prefix);
+        if (std::strncmp(arg, prefix, n) != 0) return false;
+        value = arg + n;
+        return true;
+    }
+}
+
+const Bench::Options& Bench::options() { return opts; }
+
+void Bench::report(const Row& row) { reporter.row(row); }
+
+// Usage: LiOAvIZ_Lab3_Bench [--csv=FILE] [--json=FILE] [--max-size=N] [suite...],
+// no suites runs everything
+int main(const int argc, char** argv) {
+    int first_suite = 1;
+    for (; first_suite < argc && std::strncmp(argv[first_suite], "--", 2) == 0; ++first_suite) {
+        const char* value;
+        if (starts_with(argv[first_suite], "--csv=", value)) {
+            reporter.set_csv(value);
+        } else if (starts_with(argv[first_suite], "--json=", value)) {
+            reporter.set_json(value);
+        } else if (starts_with(argv[first_suite], "--max-size=", value)) {
+            opts.max_size = std::strtoull(value, nullptr, 10);
+        } else {
+            std::cerr << "Unknown option '" << argv[first_suite] << "'" << std::endl;
+            return 1;
+        }
+    }
+
+    if (first_suite == argc) {
+        for (const auto& suite : suites) suite.run();
+        reporter.finish();
+        return 0;
+    }
+    for (int i = first_suite; i < argc; ++i) {
+        bool found = false;
+        for (const auto& suite : suites) {
+            if (std::strcmp(argv[i], suite.name) == 0) {
+                suite.run();
+                found = true;
+            }
+        }
+        if (!found) {
+            std::cerr << "Unknown suite '" << argv[i] << "'. Available:";
+            for (const auto& suite : suites) std::cerr << " " << suite.name;
+            std::cerr << std::endl;
+            return 1;
+        }
+    }
+    reporter.finish();
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include <iomanip>
+#include <iostream>
+#include <latch>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+#include "priority_q/multi_queue.h"
+#include "priority_q/priority_q.h"
+
+namespace {
+    constexpr int OPS_PER_THREAD = 200000;
+    constexpr int PREFILL = 100000;
+
+    // Global lock around the sequential heap: the baseline we are replacing
+    class LockedQueue {
+        std::mutex mutex;
+        PriorityQueue<int> heap;
+
+        public:
+        void push(const int value, const int priority) {
+            std::lock_guard lock(mutex);
+            heap.push(value, priority);
+        }
+
+        bool try_pop(int& out) {
+            std::lock_guard lock(mutex);
+            if (heap.is_empty()) return false;
+            out = heap.pop();
+            return true;
+        }
+    };
+
+    // Every thread alternates push and pop on random priorities, returns Mops/s.
+    // The clock starts once every worker is up, thread startup is not timed
+    template<typename Q>
+    double measure(Q& queue, const int threads) {
+        for (int i = 0; i < PREFILL; ++i) queue.push(i, (i * 7919) % 100000);
+
+        std::vector<std::thread> workers;
+        std::latch ready(threads);
+        std::latch go(1);
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&queue, &ready, &go, t] {
+                ready.count_down();
+                go.wait();
+                unsigned seed = 2654435761u * static_cast<unsigned>(t + 1);
+                int value;
+                for (int i = 0; i < OPS_PER_THREAD; ++i) {
+                    seed = seed * 1103515245u + 12345u;
+                    if (i % 2 == 0) queue.push(i, static_cast<int>((seed >> 8) % 100000));
+                    else queue.try_pop(value);
+                }
+            });
+        }
+        ready.wait();
+        const auto start = Bench::Clock::now();
+        go.count_down();
+        for (auto& worker : workers) worker.join();
+        return threads * static_cast<double>(OPS_PER_THREAD) / Bench::seconds_since(start) / 1e6;
+    }
+}
+
+void Bench::run_multi_queue() {
+    const unsigned hw = std::thread::hardware_concurrency();
+    const int max_threads = hw == 0 ? 4 : static_cast<int>(hw);
+
+    std::cout << "=== MultiQueue vs mutex + PriorityQueue (Mops/s) ===" << std::endl;
+    std::cout << std::setw(8) << "threads" << std::setw(14) << "locked" << std::setw(14) << "multi_queue" << std::endl;
+    // Powers of two, and the core count itself as the last point
+    for (int threads = 1;; threads = threads * 2 < max_threads ? threads * 2 : max_threads) {
+        LockedQueue locked;
+        MultiQueue<int> relaxed(threads);
+        const double locked_rate = measure(locked, threads);
+        const double relaxed_rate = measure(relaxed, threads);
+        std::cout << std::setw(8) << threads << std::fixed << std::setprecision(2)
+                  << std::setw(14) << locked_rate << std::setw(14) << relaxed_rate << std::endl;
+        if (threads == max_threads) break;
+    }
+}
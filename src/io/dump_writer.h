@@ -0,0 +1,170 @@
+#ifndef DUMP_WRITER_H
+#define DUMP_WRITER_H
+#include <cerrno>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+/*
+ * Buffered text output for container dumps.
+ * Values are formatted straight into one large buffer (std::to_chars
+ * for numbers, memcpy for strings) that goes to the sink in big chunks:
+ * one ostream::write or one write(2) per buffer instead of
+ * one operator<< per element. Types without a fast path fall
+ * back to their operator<<. A writer can be kept and reused for many dumps
+ */
+
+class DumpWriter {
+    public:
+    static constexpr size_t default_buffer_bytes = 64 * 1024;
+    static constexpr size_t no_limit = static_cast<size_t>(-1);
+
+    private:
+    // Longest to_chars output: a double in scientific form or a 64-bit integer
+    static constexpr size_t max_number_chars = 32;
+
+    std::ostream* stream;
+    int fd;
+    char* buffer;
+    size_t capacity;
+    size_t used;
+
+    void write_fd(const char* data, size_t n) const {
+        while (n > 0) {
+#ifdef _WIN32
+            const int written = ::_write(fd, data, static_cast<unsigned>(n));
+#else
+            const ssize_t written = ::write(fd, data, n);
+#endif
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                throw std::runtime_error(std::string("Dump write failed: ") + std::strerror(errno));
+            }
+            data += written;
+            n -= static_cast<size_t>(written);
+        }
+    }
+
+    void sink(const char* data, const size_t n) const {
+        if (stream != nullptr) stream->write(data, static_cast<std::streamsize>(n));
+        else write_fd(data, n);
+    }
+
+    template<typename T>
+    void put_number(const T value) {
+        if (capacity - used < max_number_chars) flush();
+        const auto [end, ec] = std::to_chars(buffer + used, buffer + capacity, value);
+        used = static_cast<size_t>(end - buffer);
+    }
+
+    template<typename T>
+    DumpWriter& append_streamed(const T& value) {
+        std::ostringstream formatted;
+        formatted << value;
+        return *this << std::string_view(formatted.view());
+    }
+
+    public:
+    explicit DumpWriter(std::ostream& os, const size_t buffer_bytes = default_buffer_bytes)
+        : stream(&os), fd(-1), capacity(buffer_bytes > max_number_chars ? buffer_bytes : default_buffer_bytes),
+          used(0) {
+        buffer = new char[capacity];
+    }
+
+    explicit DumpWriter(const int file_descriptor, const size_t buffer_bytes = default_buffer_bytes)
+        : stream(nullptr), fd(file_descriptor),
+          capacity(buffer_bytes > max_number_chars ? buffer_bytes : default_buffer_bytes), used(0) {
+        buffer = new char[capacity];
+    }
+
+    // Whatever is still buffered is written out, write errors are dropped here
+    ~DumpWriter() {
+        try {
+            flush();
+        } catch (...) {}
+        delete[] buffer;
+    }
+
+    DumpWriter(const DumpWriter&) = delete;
+    DumpWriter& operator=(const DumpWriter&) = delete;
+    DumpWriter(DumpWriter&&) = delete;
+    DumpWriter& operator=(DumpWriter&&) = delete;
+
+    // Hand the buffer to the sink. ostream errors show up in the stream state,
+    // write(2) errors throw std::runtime_error
+    void flush() {
+        if (used == 0) return;
+        const size_t n = used;
+        used = 0;
+        sink(buffer, n);
+        if (stream != nullptr) stream->flush();
+    }
+
+    [[nodiscard]] size_t get_buffered() const { return used; }
+
+    void write(const char* data, const size_t n) {
+        if (n > capacity - used) {
+            flush();
+            // Too big to be worth buffering
+            if (n >= capacity) {
+                sink(data, n);
+                return;
+            }
+        }
+        std::memcpy(buffer + used, data, n);
+        used += n;
+    }
+
+    DumpWriter& operator<<(const std::string_view s) {
+        write(s.data(), s.size());
+        return *this;
+    }
+
+    DumpWriter& operator<<(const char* s) { return *this << std::string_view(s); }
+
+    DumpWriter& operator<<(const std::string& s) { return *this << std::string_view(s); }
+
+    DumpWriter& operator<<(const char c) {
+        if (used == capacity) flush();
+        buffer[used++] = c;
+        return *this;
+    }
+
+    DumpWriter& operator<<(const bool b) { return *this << (b ? '1' : '0'); }
+
+    // Numbers, the same text operator<< gives for integers;
+    // floating point is printed in the shortest form that reads back exactly
+    template<typename T>
+        requires (std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char>)
+    DumpWriter& operator<<(const T value) {
+        if constexpr (std::is_same_v<T, signed char> || std::is_same_v<T, unsigned char>) {
+            return *this << static_cast<char>(value);
+        } else if constexpr (requires(char* p) { std::to_chars(p, p, value); }) {
+            put_number(value);
+            return *this;
+        } else {
+            return append_streamed(value);
+        }
+    }
+
+    // Anything else that has an operator<<
+    template<typename T>
+        requires (!std::is_arithmetic_v<T> && !std::is_convertible_v<const T&, std::string_view>)
+    DumpWriter& operator<<(const T& value) {
+        return append_streamed(value);
+    }
+};
+
+#endif //DUMP_WRITER_H
@@ -0,0 +1,200 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <istream>
+#include <new>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+/*
+ * Binary snapshots for Stack, Queue and PriorityQueue.
+ * Layout, native byte order and sizes:
+ *     magic "LQSN", u16 version, u8 container kind,
+ *     u8 element format, u32 element size, u64 count,
+ *     container specific fields, elements
+ * Elements are encoded by SnapshotCodec<E>: trivially copyable types
+ * as one raw block, std::string as u64 length + bytes.
+ * Specialize SnapshotCodec for other element types
+ */
+
+namespace Snapshot {
+    enum class Kind : uint8_t {
+        STACK = 1,
+        QUEUE = 2,
+        PRIORITY_QUEUE = 3,
+        SORTED_RUN = 4 // ExternalPriorityQueue spill file
+    };
+
+    inline constexpr char magic[4] = {'L', 'Q', 'S', 'N'};
+    inline constexpr uint16_t version = 1;
+
+    // Writes go straight to the stream buffer, no sentry per call
+    class Writer {
+        private:
+        std::streambuf* buf;
+
+        public:
+        explicit Writer(std::ostream& os) : buf(os.rdbuf()) {
+            if (!os || buf == nullptr) throw std::runtime_error("Snapshot stream is not writable");
+        }
+
+        void put(const void* data, const size_t n) {
+            if (n == 0) return;
+            const auto written = buf->sputn(static_cast<const char*>(data), static_cast<std::streamsize>(n));
+            if (written != static_cast<std::streamsize>(n)) throw std::runtime_error("Snapshot write failed");
+        }
+
+        template<typename T>
+        void put(const T value) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            put(&value, sizeof(T));
+        }
+    };
+
+    // Reads exactly what was asked for, never past the end of the snapshot
+    class Reader {
+        private:
+        std::streambuf* buf;
+
+        public:
+        explicit Reader(std::istream& is) : buf(is.rdbuf()) {
+            if (!is || buf == nullptr) throw std::runtime_error("Snapshot stream is not readable");
+        }
+
+        void get(void* data, const size_t n) {
+            if (n == 0) return;
+            const auto got = buf->sgetn(static_cast<char*>(data), static_cast<std::streamsize>(n));
+            if (got != static_cast<std::streamsize>(n)) throw std::runtime_error("Snapshot is truncated");
+        }
+
+        template<typename T>
+        T get() {
+            static_assert(std::is_trivially_copyable_v<T>);
+            T value;
+            get(&value, sizeof(T));
+            return value;
+        }
+    };
+}
+
+/*
+ * Element encoding. A codec provides
+ *     format, element_size                       - checked on load
+ *     write(Writer&, const E* items, size_t n)
+ *     read(Reader&, E* raw, size_t n)            - constructs n elements in raw storage,
+ *                                                  or none if it throws
+ */
+template<typename E, typename = void>
+struct SnapshotCodec;
+
+template<typename E>
+struct SnapshotCodec<E, std::enable_if_t<std::is_trivially_copyable_v<E>>> {
+    static constexpr uint8_t format = 0;
+    static constexpr uint32_t element_size = sizeof(E);
+
+    static void write(Snapshot::Writer& w, const E* items, const size_t n) {
+        w.put(items, n * sizeof(E));
+    }
+
+    static void read(Snapshot::Reader& r, E* raw, const size_t n) {
+        r.get(static_cast<void*>(raw), n * sizeof(E));
+    }
+};
+
+template<>
+struct SnapshotCodec<std::string> {
+    static constexpr uint8_t format = 1;
+    static constexpr uint32_t element_size = 0;
+
+    static void write(Snapshot::Writer& w, const std::string* items, const size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            w.put(static_cast<uint64_t>(items[i].size()));
+            w.put(items[i].data(), items[i].size());
+        }
+    }
+
+    static void read(Snapshot::Reader& r, std::string* raw, const size_t n) {
+        size_t built = 0;
+        try {
+            while (built < n) {
+                const auto length = r.get<uint64_t>();
+                auto s = ::new (raw + built) std::string();
+                ++built;
+                s->resize(static_cast<size_t>(length));
+                r.get(s->data(), s->size());
+            }
+        } catch (...) {
+            for (size_t i = 0; i < built; ++i) raw[i].~basic_string();
+            throw;
+        }
+    }
+};
+
+namespace Snapshot {
+    template<typename E>
+    void write_header(Writer& w, const Kind kind, const uint64_t count) {
+        w.put(magic, sizeof(magic));
+        w.put(version);
+        w.put(static_cast<uint8_t>(kind));
+        w.put(SnapshotCodec<E>::format);
+        w.put(SnapshotCodec<E>::element_size);
+        w.put(count);
+    }
+
+    // Returns the element count
+    template<typename E>
+    uint64_t read_header(Reader& r, const Kind kind) {
+        char m[sizeof(magic)];
+        r.get(m, sizeof(m));
+        for (size_t i = 0; i < sizeof(magic); ++i) {
+            if (m[i] != magic[i]) throw std::runtime_error("Not a snapshot");
+        }
+        const auto v = r.get<uint16_t>();
+        if (v != version) {
+            if (v == static_cast<uint16_t>(version << 8)) throw std::runtime_error("Snapshot byte order mismatch");
+            throw std::runtime_error("Unsupported snapshot version");
+        }
+        if (r.get<uint8_t>() != static_cast<uint8_t>(kind)) throw std::runtime_error("Snapshot holds another container kind");
+        const auto format = r.get<uint8_t>();
+        const auto element_size = r.get<uint32_t>();
+        if (format != SnapshotCodec<E>::format || element_size != SnapshotCodec<E>::element_size) {
+            throw std::runtime_error("Snapshot element type mismatch");
+        }
+        return r.get<uint64_t>();
+    }
+
+    // Write through a temporary file and rename it over path,
+    // so a crash mid-save never leaves a half-written snapshot behind
+    template<typename F>
+    void save_file(const std::filesystem::path& path, F write) {
+        std::filesystem::path temp = path;
+        temp += ".tmp";
+        try {
+            std::ofstream os(temp, std::ios::binary | std::ios::trunc);
+            if (!os) throw std::runtime_error("Cannot open snapshot file: " + temp.string());
+            write(os);
+            os.close();
+            if (!os) throw std::runtime_error("Snapshot write failed: " + temp.string());
+        } catch (...) {
+            std::error_code ignored;
+            std::filesystem::remove(temp, ignored);
+            throw;
+        }
+        std::filesystem::rename(temp, path);
+    }
+
+    template<typename F>
+    void load_file(const std::filesystem::path& path, F read) {
+        std::ifstream is(path, std::ios::binary);
+        if (!is) throw std::runtime_error("Cannot open snapshot file: " + path.string());
+        read(is);
+    }
+}
+
+#endif //SNAPSHOT_H
@@ -1,25 +1,57 @@
+#include <cstring>
 #include <iostream>
 #include <string>
 
+#include "allocator_tests/test_allocator.h"
 #include "priority_q/priority_q.h"
 #include "priority_q_tests/test_priority_q.h"
 #include "queue/queue.h"
 #include "queue_tests/test_queue.h"
+#include "scheduler_tests/test_scheduler.h"
 #include "stack/stack.h"
 #include "stack_tests/test_stack.h"
 #include "utils/utils.h"
+#include "utils_tests/test_utils.h"
 
 // перебор всех типов
 // удаление части очереди
 
-int main() {
+int main(const int argc, char** argv) {
     /*
      * There`s four modes:
      * 1. demo - automatically push and pop elements
      * 2. test - do every sort of tests
      * 3. free - write your own code and have fun
      * 4. playground - interactive mode
+     * Batch mode skips the menu and runs playground commands:
+     *     LiOAvIZ_Lab3 --batch <file|-> [--type int|double|string] [--quiet]
      */
+    if (argc > 1) {
+        std::string path;
+        std::string type = "int";
+        bool quiet = false;
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--batch") == 0 && i + 1 < argc) path = argv[++i];
+            else if (std::strcmp(argv[i], "--type") == 0 && i + 1 < argc) type = argv[++i];
+            else if (std::strcmp(argv[i], "--quiet") == 0) quiet = true;
+            else {
+                std::cerr << "Usage: " << argv[0] << " --batch <file|-> [--type int|double|string] [--quiet]"
+                          << std::endl;
+                return 1;
+            }
+        }
+        if (path.empty()) {
+            std::cerr << "--batch <file|-> is required" << std::endl;
+            return 1;
+        }
+        try {
+            return Utils::run_batch_mode(path, type, quiet);
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
     while (true) {
         std::string mode = Utils::get_valid_mode();
 
@@ -27,8 +59,19 @@ int main() {
             if (mode == "test") {
                 std::cout << "=== Running Tests ===" << std::endl;
                 run_tests_priority_q();
+                run_tests_multi_queue();
+                run_tests_pairing_priority_q();
+                run_tests_external_priority_q();
                 run_tests_queue();
+                run_tests_mpmc_queue();
+                run_tests_spsc_queue();
+                run_tests_mmap_queue();
+                run_tests_spill_queue();
                 run_tests_stack();
+                run_tests_concurrent_stack();
+                run_tests_scheduler();
+                run_tests_allocator();
+                run_tests_playground();
                 std::cout << "\n=== All Tests Completed ===" << std::endl;
             }
             if (mode == "demo") {
@@ -36,6 +79,7 @@ int main() {
                 run_demo_priority_q();
                 run_demo_queue();
                 run_demo_stack();
+                run_demo_scheduler();
             }
             if (mode == "free") {
                 std::cout << "\n=== Running Free Mode ===" << std::endl;
@@ -68,7 +112,7 @@ void Utils::run_free_mode() {
     for (int i = 1; i <= 10; i++) {
         q.push(i);
     }
-    q.remove_from(5);
+    q.truncate_from(5);
     q.peek_q();
     std::cout << std::endl;
     std::cout << q.pop() << std::endl;
@@ -0,0 +1,309 @@
+#ifndef EXTERNAL_PRIORITY_Q_H
+#define EXTERNAL_PRIORITY_Q_H
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "io/snapshot.h"
+#include "priority_q.h"
+#include "queue/queue.h"
+
+/*
+ * Priority queue for backlogs larger than RAM.
+ * New elements go to an in-memory PriorityQueue<E>. When it holds half
+ * the budget it is drained in pop order into a sorted run on disk.
+ * pop merges lazily: every run keeps a small read buffer and the best
+ * of the run heads and the heap top is taken. Runs are older than the
+ * heap and ordered among themselves, so equal priorities still pop
+ * in push order.
+ * Runs are merged in tiers: merge_width runs of one level become one
+ * run of the next, so an element is rewritten about
+ * log_4(size / heap) times. At max_runs all runs are merged into one.
+ * RAM holds the heap plus one buffer per run, within the budget in
+ * elements; a merge runs right after a flush, so its second set of
+ * buffers takes the room of the emptied heap.
+ * Runs are snapshot files (see io/snapshot.h), so E needs a
+ * SnapshotCodec, and a copy constructor for merging runs
+ */
+
+template<typename E>
+class ExternalPriorityQueue {
+    public:
+    static constexpr size_t max_runs = 16;
+    static constexpr size_t merge_width = 4;
+
+    private:
+    struct Entry {
+        E data;
+        int priority;
+    };
+
+    // A sorted run on disk, read ahead through buffer
+    struct Run {
+        std::filesystem::path path;
+        std::ifstream file;
+        Snapshot::Reader reader;
+        Queue<Entry> buffer;
+        size_t unread; // entries still in the file
+        unsigned level;
+
+        static std::ifstream open(const std::filesystem::path& path) {
+            std::ifstream is(path, std::ios::binary);
+            if (!is) throw std::runtime_error("Cannot open priority queue run: " + path.string());
+            return is;
+        }
+
+        Run(std::filesystem::path run_path, const unsigned run_level, const size_t chunk)
+            : path(static_cast<std::filesystem::path&&>(run_path)), file(open(path)), reader(file), unread(0),
+              level(run_level) {
+            unread = static_cast<size_t>(Snapshot::read_header<E>(reader, Snapshot::Kind::SORTED_RUN));
+            fill(chunk);
+        }
+
+        // Second reader over what other has not handed out yet
+        explicit Run(Run& other)
+            : path(other.path), file(open(path)), reader(file), buffer(other.buffer), unread(other.unread),
+              level(other.level) {
+            file.seekg(other.file.tellg());
+            if (!file) throw std::runtime_error("Cannot seek priority queue run: " + path.string());
+        }
+
+        [[nodiscard]] size_t get_size() const { return buffer.get_size() + unread; }
+
+        [[nodiscard]] const Entry& head() const { return buffer.peek_head(); }
+
+        void fill(const size_t chunk) {
+            for (size_t n = unread < chunk ? unread : chunk; n > 0; --n, --unread) {
+                const auto priority = reader.get<int32_t>();
+                alignas(E) unsigned char raw[sizeof(E)];
+                SnapshotCodec<E>::read(reader, reinterpret_cast<E*>(raw), 1);
+                E* e = std::launder(reinterpret_cast<E*>(raw));
+                try {
+                    buffer.push(Entry{static_cast<E&&>(*e), priority});
+                } catch (...) {
+                    e->~E();
+                    throw;
+                }
+                e->~E();
+            }
+        }
+
+        // The buffer is refilled once empty
+        Entry take(const size_t chunk) {
+            Entry res = buffer.pop();
+            if (buffer.is_empty()) fill(chunk);
+            return res;
+        }
+    };
+
+    PriorityQueue<E> heap;
+    std::vector<std::unique_ptr<Run>> runs; // oldest first, levels never rise, none empty
+    size_t on_runs;                         // elements in runs, buffered or not
+    size_t budget;
+    size_t heap_limit;
+    size_t chunk;                           // run buffer size
+    std::filesystem::path directory;
+    std::string prefix;
+    unsigned long long next_run;
+
+    static constexpr size_t from_heap = static_cast<size_t>(-1);
+
+    std::filesystem::path run_path() {
+        return directory / (prefix + std::to_string(next_run++) + ".run");
+    }
+
+    static void write_entry(Snapshot::Writer& w, const Entry& entry) {
+        w.put(static_cast<int32_t>(entry.priority));
+        SnapshotCodec<E>::write(w, &entry.data, 1);
+    }
+
+    // Best head among sources. Runs are scanned oldest first and the heap
+    // last, only a strictly higher priority replaces the pick, so ties go
+    // to the older element. A linear scan, there are at most max_runs runs
+    template<typename Runs>
+    static size_t pick(const Runs& sources, const PriorityQueue<E>* h) {
+        size_t best = sources.size();
+        int best_priority = 0;
+        for (size_t i = 0; i < sources.size(); ++i) {
+            if (best == sources.size() || sources[i]->head().priority > best_priority) {
+                best = i;
+                best_priority = sources[i]->head().priority;
+            }
+        }
+        if (h != nullptr && !h->is_empty() && (best == sources.size() || h->top_priority() > best_priority)) {
+            return from_heap;
+        }
+        return best;
+    }
+
+    // Write count entries produced by next() to a new run file and open it
+    template<typename F>
+    std::unique_ptr<Run> write_run(const size_t count, const unsigned level, F next) {
+        const auto path = run_path();
+        try {
+            {
+                std::ofstream os(path, std::ios::binary | std::ios::trunc);
+                if (!os) throw std::runtime_error("Cannot create priority queue run: " + path.string());
+                Snapshot::Writer w(os);
+                Snapshot::write_header<E>(w, Snapshot::Kind::SORTED_RUN, count);
+                for (size_t i = 0; i < count; ++i) write_entry(w, next());
+                os.close();
+                if (!os) throw std::runtime_error("Priority queue run write failed: " + path.string());
+            }
+            return std::make_unique<Run>(path, level, chunk);
+        } catch (...) {
+            std::error_code ignored;
+            std::filesystem::remove(path, ignored);
+            throw;
+        }
+    }
+
+    // Drain the heap into a new run. It is drained into RAM first,
+    // so a failed write puts everything back
+    void flush_heap() {
+        Queue<Entry> sorted;
+        sorted.reserve(heap.get_size());
+        while (!heap.is_empty()) {
+            const int priority = heap.top_priority();
+            sorted.push(Entry{heap.pop(), priority});
+        }
+        const size_t count = sorted.get_size();
+        try {
+            auto it = sorted.begin();
+            runs.push_back(write_run(count, 0, [&it]() -> const Entry& { return *it++; }));
+        } catch (...) {
+            while (!sorted.is_empty()) {
+                Entry entry = sorted.pop();
+                heap.push(static_cast<E&&>(entry.data), entry.priority);
+            }
+            throw;
+        }
+        on_runs += count;
+        compact();
+    }
+
+    void compact() {
+        for (;;) {
+            size_t first = runs.size();
+            while (first > 0 && runs[first - 1]->level == runs.back()->level) --first;
+            if (runs.size() - first >= merge_width) merge_runs(first, runs.back()->level + 1);
+            else if (runs.size() >= max_runs) merge_runs(0, runs.front()->level + 1);
+            else break;
+        }
+    }
+
+    // Merge runs [first, end) into one. The merge reads through second
+    // readers, the runs themselves are only dropped once the new one is complete
+    void merge_runs(const size_t first, const unsigned level) {
+        std::vector<std::unique_ptr<Run>> sources;
+        size_t count = 0;
+        for (size_t i = first; i < runs.size(); ++i) {
+            sources.push_back(std::make_unique<Run>(*runs[i]));
+            count += runs[i]->get_size();
+        }
+        auto merged = write_run(count, level, [this, &sources]() {
+            const size_t i = pick(sources, nullptr);
+            Entry res = sources[i]->take(chunk);
+            if (sources[i]->get_size() == 0) sources.erase(sources.begin() + static_cast<std::ptrdiff_t>(i));
+            return res;
+        });
+        while (runs.size() > first) remove_run(runs.size() - 1);
+        runs.push_back(static_cast<std::unique_ptr<Run>&&>(merged));
+    }
+
+    void remove_run(const size_t i) {
+        std::error_code ignored;
+        runs[i]->file.close();
+        std::filesystem::remove(runs[i]->path, ignored);
+        runs.erase(runs.begin() + static_cast<std::ptrdiff_t>(i));
+    }
+
+    const Entry* run_head(const size_t source) const {
+        return source == from_heap ? nullptr : &runs[source]->head();
+    }
+
+    public:
+    // budget: elements kept in RAM, at least 2 * max_runs so every run gets a buffer.
+    // directory: where runs go, the system temp directory by default
+    explicit ExternalPriorityQueue(const size_t memory_budget,
+                                   std::filesystem::path run_directory = std::filesystem::temp_directory_path())
+        : on_runs(0), budget(memory_budget < 2 * max_runs ? 2 * max_runs : memory_budget), heap_limit(budget / 2),
+          chunk(budget / 2 / max_runs),
+          directory(static_cast<std::filesystem::path&&>(run_directory)), next_run(0) {
+        std::random_device random;
+        prefix = "epq_" + std::to_string(random()) + "_" + std::to_string(reinterpret_cast<uintptr_t>(this)) + "_";
+    }
+
+    // Runs left behind are deleted
+    ~ExternalPriorityQueue() {
+        while (!runs.empty()) remove_run(runs.size() - 1);
+    }
+
+    ExternalPriorityQueue(const ExternalPriorityQueue&) = delete;
+    ExternalPriorityQueue& operator=(const ExternalPriorityQueue&) = delete;
+    ExternalPriorityQueue(ExternalPriorityQueue&&) = delete;
+    ExternalPriorityQueue& operator=(ExternalPriorityQueue&&) = delete;
+
+    // == Basic operations ==
+    [[nodiscard]] bool is_empty() const { return get_size() == 0; }
+
+    [[nodiscard]] size_t get_size() const { return heap.get_size() + on_runs; }
+
+    [[nodiscard]] size_t get_budget() const { return budget; }
+
+    // Elements held in RAM: the heap and the run buffers
+    [[nodiscard]] size_t get_in_memory() const {
+        size_t res = heap.get_size();
+        for (const auto& run : runs) res += run->buffer.get_size();
+        return res;
+    }
+
+    // Elements only on disk
+    [[nodiscard]] size_t get_on_disk() const { return get_size() - get_in_memory(); }
+
+    [[nodiscard]] size_t get_run_count() const { return runs.size(); }
+
+    void push(E&& value, const int priority) {
+        heap.push(static_cast<E&&>(value), priority);
+        if (heap.get_size() >= heap_limit) flush_heap();
+    }
+
+    void push(const E& value, const int priority) {
+        heap.push(value, priority);
+        if (heap.get_size() >= heap_limit) flush_heap();
+    }
+
+    [[maybe_unused]] const E& top() const {
+        if (is_empty()) throw std::out_of_range("Priority queue is empty");
+        const Entry* head = run_head(pick(runs, &heap));
+        return head == nullptr ? heap.top() : head->data;
+    }
+
+    [[nodiscard]] int top_priority() const {
+        if (is_empty()) throw std::out_of_range("Priority queue is empty");
+        const Entry* head = run_head(pick(runs, &heap));
+        return head == nullptr ? heap.top_priority() : head->priority;
+    }
+
+    // May read the next chunk of a run
+    E pop() {
+        if (is_empty()) throw std::out_of_range("Priority queue is empty");
+        const size_t source = pick(runs, &heap);
+        if (source == from_heap) return heap.pop();
+        Run& run = *runs[source];
+        Entry res = run.take(chunk);
+        --on_runs;
+        if (run.get_size() == 0) remove_run(source);
+        return static_cast<E&&>(res.data);
+    }
+};
+
+#endif //EXTERNAL_PRIORITY_Q_H
@@ -0,0 +1,157 @@
+#ifndef MULTI_QUEUE_H
+#define MULTI_QUEUE_H
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+
+#include "priority_q.h"
+
+/*
+ * Relaxed concurrent priority queue (MultiQueue).
+ * threads * relaxation independent heaps, each behind its own try-lock.
+ * push goes to a random heap, pop looks at the cached tops of two random
+ * heaps and takes from the better one. No global lock, so throughput
+ * grows with cores; in exchange pop returns one of the roughly
+ * threads * relaxation best elements rather than the very best one.
+ * With a single heap (threads = relaxation = 1) the order is exact
+ */
+
+template<typename E, size_t Arity = 2>
+class MultiQueue {
+    private:
+    static constexpr size_t cache_line = 64;
+    // Wider than int, so every real priority differs from it
+    static constexpr long long empty_top = LLONG_MIN;
+
+    struct alignas(cache_line) Shard {
+        std::atomic<bool> locked{false};
+        // Priority of the heap top, readable without the lock
+        std::atomic<long long> top{empty_top};
+        PriorityQueue<E, Arity> heap;
+
+        bool try_lock() {
+            return !locked.load(std::memory_order_relaxed) && !locked.exchange(true, std::memory_order_acquire);
+        }
+
+        void unlock() {
+            top.store(heap.is_empty() ? empty_top : heap.top_priority(), std::memory_order_relaxed);
+            locked.store(false, std::memory_order_release);
+        }
+    };
+
+    Shard* shards;
+    size_t shard_count;
+    alignas(cache_line) std::atomic<size_t> size;
+
+    // Per-thread xorshift, shared by every MultiQueue
+    static size_t random_index(const size_t bound) {
+        static thread_local unsigned long long state =
+            std::hash<std::thread::id>{}(std::this_thread::get_id()) | 1;
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return static_cast<size_t>(state % bound);
+    }
+
+    template<typename T>
+    void emplace(T&& value, const int priority) {
+        while (true) {
+            Shard& shard = shards[random_index(shard_count)];
+            if (!shard.try_lock()) continue;
+            shard.heap.push(static_cast<T&&>(value), priority);
+            size.fetch_add(1, std::memory_order_relaxed);
+            shard.unlock();
+            return;
+        }
+    }
+
+    bool pop_from(Shard& shard, E& out) {
+        if (shard.heap.is_empty()) return false;
+        out = shard.heap.pop();
+        size.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    public:
+    // ==Constructor==
+    explicit MultiQueue(const size_t threads = std::thread::hardware_concurrency(), const size_t relaxation = 2)
+        : shard_count(threads * relaxation > 0 ? threads * relaxation : 1), size(0) {
+        shards = new Shard[shard_count];
+    }
+    // ==Destructor==
+    ~MultiQueue() {
+        delete[] shards;
+    }
+
+    // ==Prohibit assignment and movement==
+    MultiQueue& operator=(const MultiQueue&) = delete;
+    MultiQueue(const MultiQueue&) = delete;
+    MultiQueue(MultiQueue&&) = delete;
+    MultiQueue& operator=(MultiQueue&&) = delete;
+
+    // ==Basic operations==
+    // Only a snapshot when called concurrently
+    [[nodiscard]] bool is_empty() const { return size.load(std::memory_order_relaxed) == 0; }
+
+    [[nodiscard]] size_t get_size() const { return size.load(std::memory_order_relaxed); }
+
+    [[nodiscard]] size_t get_shard_count() const { return shard_count; }
+
+    // Highest priority among the shard tops, a snapshot as well
+    [[nodiscard]] int top_priority() const {
+        long long best = empty_top;
+        for (size_t i = 0; i < shard_count; ++i) {
+            const long long top = shards[i].top.load(std::memory_order_relaxed);
+            if (top > best) best = top;
+        }
+        if (best == empty_top) throw std::out_of_range("Priority queue is empty");
+        return static_cast<int>(best);
+    }
+
+    void push(E&& value, int priority) {
+        emplace(static_cast<E&&>(value), priority);
+    }
+
+    void push(const E& value, int priority) {
+        emplace(value, priority);
+    }
+
+    // False only if every shard was seen empty
+    bool try_pop(E& out) {
+        while (!is_empty()) {
+            Shard& a = shards[random_index(shard_count)];
+            Shard& b = shards[random_index(shard_count)];
+            const long long top_a = a.top.load(std::memory_order_relaxed);
+            const long long top_b = b.top.load(std::memory_order_relaxed);
+            Shard& best = top_b > top_a ? b : a;
+            if ((top_b > top_a ? top_b : top_a) == empty_top) {
+                // Both picks look empty, fall back to a sweep so a sparse queue still drains
+                for (size_t i = 0; i < shard_count; ++i) {
+                    Shard& shard = shards[i];
+                    if (shard.top.load(std::memory_order_relaxed) == empty_top || !shard.try_lock()) continue;
+                    const bool popped = pop_from(shard, out);
+                    shard.unlock();
+                    if (popped) return true;
+                }
+                continue;
+            }
+            if (!best.try_lock()) continue;
+            const bool popped = pop_from(best, out);
+            best.unlock();
+            if (popped) return true;
+        }
+        return false;
+    }
+
+    // E must be default constructible
+    E pop() {
+        E res;
+        if (!try_pop(res)) throw std::out_of_range("Priority queue is empty");
+        return res;
+    }
+};
+
+#endif //MULTI_QUEUE_H
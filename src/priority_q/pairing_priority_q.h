@@ -0,0 +1,265 @@
+#ifndef PAIRING_PRIORITY_Q_H
+#define PAIRING_PRIORITY_Q_H
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+#include "allocator/allocator.h"
+#include "io/dump_writer.h"
+
+/*
+ * Meldable priority queue on a pairing heap.
+ * Nodes are linked like the old list-based PriorityQueue, but as a
+ * tree (first child, next sibling). push and merge link two roots in O(1),
+ * pop does the two-pass pairing in O(log n) amortized.
+ * Sequence numbers come from one process-wide counter, so elements
+ * with equal priority keep push order even across merged queues
+ */
+
+template<typename E, typename Alloc = HeapAllocator>
+class PairingPriorityQueue {
+    private:
+    struct Node {
+        E data;
+        int priority;
+        unsigned long long seq;
+        Node* child;
+        Node* sibling;
+
+        Node(const E& d, const int p, const unsigned long long s)
+            : data(d), priority(p), seq(s), child(nullptr), sibling(nullptr) {}
+        Node(E&& d, const int p, const unsigned long long s)
+            : data(static_cast<E&&>(d)), priority(p), seq(s), child(nullptr), sibling(nullptr) {}
+    };
+
+    size_t size;
+    Node* root;
+    [[no_unique_address]] Alloc allocator;
+
+    static unsigned long long next_seq() {
+        static std::atomic<unsigned long long> counter{0};
+        return counter.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static bool before(const Node* a, const Node* b) {
+        return a->priority > b->priority || (a->priority == b->priority && a->seq < b->seq);
+    }
+
+    // Link two roots, the loser becomes the first child of the winner
+    static Node* meld(Node* a, Node* b) {
+        if (a == nullptr) return b;
+        if (b == nullptr) return a;
+        if (before(b, a)) {
+            Node* temp = a;
+            a = b;
+            b = temp;
+        }
+        b->sibling = a->child;
+        a->child = b;
+        return a;
+    }
+
+    // Two-pass pairing of a sibling list: meld pairs left to right, then fold right to left
+    static Node* merge_pairs(Node* first) {
+        Node* paired = nullptr; // melded pairs, reversed through sibling links
+        while (first != nullptr) {
+            Node* a = first;
+            Node* b = a->sibling;
+            first = b ? b->sibling : nullptr;
+            a->sibling = nullptr;
+            if (b) b->sibling = nullptr;
+            Node* pair = meld(a, b);
+            pair->sibling = paired;
+            paired = pair;
+        }
+        Node* result = nullptr;
+        while (paired != nullptr) {
+            Node* next = paired->sibling;
+            paired->sibling = nullptr;
+            result = meld(result, paired);
+            paired = next;
+        }
+        return result;
+    }
+
+    template<typename T>
+    Node* new_node(T&& value, const int priority, const unsigned long long seq) {
+        return ::new (allocator.allocate(sizeof(Node), alignof(Node))) Node(static_cast<T&&>(value), priority, seq);
+    }
+
+    void free_node(Node* node) {
+        node->~Node();
+        allocator.deallocate(node, sizeof(Node), alignof(Node));
+    }
+
+    template<typename T>
+    void emplace(T&& value, const int priority) {
+        root = meld(root, new_node(static_cast<T&&>(value), priority, next_seq()));
+        ++size;
+    }
+
+    // Visit every node, order unspecified. Children are hoisted into the
+    // sibling chain as we go, so no stack is needed; the tree is consumed
+    template<typename F>
+    static void consume(Node* node, F f) {
+        while (node != nullptr) {
+            if (node->child != nullptr) {
+                Node* c = node->child;
+                node->child = c->sibling;
+                c->sibling = node->sibling;
+                node->sibling = c;
+            } else {
+                Node* next = node->sibling;
+                f(node);
+                node = next;
+            }
+        }
+    }
+
+    // Visit every node without changing the tree
+    template<typename F>
+    void for_each_node(F f) const {
+        if (root == nullptr) return;
+        const std::unique_ptr<const Node*[]> pending(new const Node*[size]);
+        size_t top = 0;
+        pending[top++] = root;
+        while (top > 0) {
+            const Node* node = pending[--top];
+            f(node);
+            for (const Node* c = node->child; c != nullptr; c = c->sibling) pending[top++] = c;
+        }
+    }
+
+    void clear() {
+        if constexpr (Alloc::releases_in_bulk && std::is_trivially_destructible_v<E>) {
+            root = nullptr;
+        } else {
+            consume(root, [this](Node* node) { free_node(node); });
+            root = nullptr;
+        }
+        size = 0;
+    }
+
+    public:
+    // ==Constructor==
+    explicit PairingPriorityQueue(const Alloc& alloc = Alloc()) : size(0), root(nullptr), allocator(alloc) {}
+    // ==Destructor==
+    ~PairingPriorityQueue() {
+        clear();
+    }
+
+    // ==Prohibit assignment==
+    PairingPriorityQueue& operator=(const PairingPriorityQueue&) = delete;
+    PairingPriorityQueue(const PairingPriorityQueue&) = delete;
+    // ==Prohibit movement==
+    PairingPriorityQueue(PairingPriorityQueue&&) = delete;
+    PairingPriorityQueue& operator=(PairingPriorityQueue&&) = delete;
+
+    // ==Basic operations==
+    [[nodiscard]] bool is_empty() const { return size == 0; }
+
+    [[nodiscard]] size_t get_size() const { return size; }
+
+    [[maybe_unused]] const E& top() const {
+        if (is_empty()) throw std::out_of_range("Priority queue is empty");
+        return root->data;
+    }
+
+    [[nodiscard]] int top_priority() const {
+        if (is_empty()) throw std::out_of_range("Priority queue is empty");
+        return root->priority;
+    }
+
+    void push(E&& value, int priority) {
+        emplace(static_cast<E&&>(value), priority);
+    }
+
+    void push(const E& value, int priority) {
+        emplace(value, priority);
+    }
+
+    E pop() {
+        if (is_empty()) throw std::out_of_range("Priority queue is empty");
+        Node* old = root;
+        E res = static_cast<E&&>(old->data);
+        root = merge_pairs(old->child);
+        free_node(old);
+        --size;
+        return res;
+    }
+
+    // Take every element of other, other ends up empty.
+    // O(1) when both share an allocator, otherwise O(m) node copies
+    void merge(PairingPriorityQueue&& other) {
+        if (this == &other || other.is_empty()) return;
+        if (allocator == other.allocator) {
+            root = meld(root, other.root);
+        } else {
+            consume(other.root, [this, &other](Node* node) {
+                root = meld(root, new_node(static_cast<E&&>(node->data), node->priority, node->seq));
+                other.free_node(node);
+            });
+        }
+        size += other.size;
+        other.root = nullptr;
+        other.size = 0;
+    }
+
+    // Earliest pushed element with this priority
+    E find_by_priority(const int& prior) const {
+        const Node* found = nullptr;
+        for_each_node([&](const Node* node) {
+            if (node->priority == prior && (!found || node->seq < found->seq)) found = node;
+        });
+        if (!found) throw std::out_of_range("Element with specified priority not found");
+        return found->data;
+    }
+
+    [[nodiscard]] bool contains_by_priority(const int prior) const {
+        bool found = false;
+        for_each_node([&](const Node* node) { found = found || node->priority == prior; });
+        return found;
+    }
+
+    // Priority of the match that would be popped first
+    int find_by_value(const E& value) const {
+        const Node* found = nullptr;
+        for_each_node([&](const Node* node) {
+            if (node->data == value && (!found || before(node, found))) found = node;
+        });
+        return found ? found->priority : -1;
+    }
+
+    // Up to limit elements as value(priority) in pop order, see PriorityQueue::dump
+    void dump(DumpWriter& out, const size_t limit = DumpWriter::no_limit) const {
+        const size_t shown = limit < size ? limit : size;
+        const std::unique_ptr<const Node*[]> order(new const Node*[size]);
+        size_t count = 0;
+        for_each_node([&](const Node* node) { order[count++] = node; });
+        std::partial_sort(order.get(), order.get() + shown, order.get() + size, before);
+        for (size_t i = 0; i < shown; ++i) out << order[i]->data << '(' << order[i]->priority << ") ";
+        if (shown < size) out << "... (" << size - shown << " more)";
+    }
+
+    void dump(std::ostream& os, const size_t limit = DumpWriter::no_limit) const {
+        DumpWriter out(os);
+        dump(out, limit);
+    }
+
+    void dump_to(const int fd, const size_t limit = DumpWriter::no_limit) const {
+        DumpWriter out(fd);
+        dump(out, limit);
+    }
+
+    void peek_pq() const {
+        if (is_empty()) throw std::out_of_range("Priority queue is empty");
+        dump(std::cout);
+    }
+};
+
+#endif //PAIRING_PRIORITY_Q_H
@@ -0,0 +1,113 @@
+#ifndef PRIORITY_INDEX_H
+#define PRIORITY_INDEX_H
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Index policies for PriorityQueue.
+ * The queue reports every element by its handle slot:
+ *     on_insert(slot, value, priority)  - element entered with a fresh sequence number
+ *     on_erase(slot, value, priority)   - element left (pop or erase)
+ * update_priority is reported as erase + insert, matching its
+ * "queued as if pushed now" semantics
+ */
+
+// Default: no index, lookups fall back to a linear scan of the heap
+struct NoIndex {
+    static constexpr bool enabled = false;
+
+    template<typename E>
+    void on_insert(size_t, const E&, int) {}
+    template<typename E>
+    void on_erase(size_t, const E&, int) {}
+};
+
+/*
+ * Two hash maps of intrusive lists over handle slots:
+ * priority -> slots in push order, value -> slots in push order.
+ * find_by_priority/contains_by_priority become O(1) on average,
+ * find_by_value costs O(number of equal values).
+ * Costs two hash updates per push and pop, see the indexed_pq bench
+ */
+template<typename E, typename Hash = std::hash<E>>
+class HashIndex {
+    public:
+    static constexpr bool enabled = true;
+    static constexpr size_t none = static_cast<size_t>(-1);
+
+    private:
+    struct Links {
+        size_t prev_by_priority;
+        size_t next_by_priority;
+        size_t prev_by_value;
+        size_t next_by_value;
+    };
+
+    struct List {
+        size_t head;
+        size_t tail;
+    };
+
+    std::unordered_map<int, List> by_priority;
+    std::unordered_map<E, List, Hash> by_value;
+    std::vector<Links> links;
+
+    template<size_t Links::*Prev, size_t Links::*Next>
+    void append(List& list, const size_t slot) {
+        links[slot].*Prev = list.tail;
+        links[slot].*Next = none;
+        if (list.tail != none) links[list.tail].*Next = slot;
+        else list.head = slot;
+        list.tail = slot;
+    }
+
+    // True if the list became empty
+    template<size_t Links::*Prev, size_t Links::*Next>
+    bool unlink(List& list, const size_t slot) {
+        const size_t prev = links[slot].*Prev;
+        const size_t next = links[slot].*Next;
+        if (prev != none) links[prev].*Next = next;
+        else list.head = next;
+        if (next != none) links[next].*Prev = prev;
+        else list.tail = prev;
+        return list.head == none;
+    }
+
+    public:
+    void on_insert(const size_t slot, const E& value, const int priority) {
+        if (slot >= links.size()) links.resize(slot + 1);
+        append<&Links::prev_by_priority, &Links::next_by_priority>(
+            by_priority.try_emplace(priority, List{none, none}).first->second, slot);
+        append<&Links::prev_by_value, &Links::next_by_value>(
+            by_value.try_emplace(value, List{none, none}).first->second, slot);
+    }
+
+    void on_erase(const size_t slot, const E& value, const int priority) {
+        const auto p = by_priority.find(priority);
+        if (unlink<&Links::prev_by_priority, &Links::next_by_priority>(p->second, slot)) by_priority.erase(p);
+        const auto v = by_value.find(value);
+        if (unlink<&Links::prev_by_value, &Links::next_by_value>(v->second, slot)) by_value.erase(v);
+    }
+
+    // Earliest pushed slot with this priority, none if absent
+    [[nodiscard]] size_t first_with_priority(const int priority) const {
+        const auto it = by_priority.find(priority);
+        return it == by_priority.end() ? none : it->second.head;
+    }
+
+    [[nodiscard]] bool contains_priority(const int priority) const {
+        return by_priority.contains(priority);
+    }
+
+    // Call f(slot) for every element equal to value
+    template<typename F>
+    void for_each_with_value(const E& value, F f) const {
+        const auto it = by_value.find(value);
+        if (it == by_value.end()) return;
+        for (size_t slot = it->second.head; slot != none; slot = links[slot].next_by_value) f(slot);
+    }
+};
+
+#endif //PRIORITY_INDEX_H
@@ -1,140 +1,635 @@
 #ifndef PRIORITY_Q_H
 #define PRIORITY_Q_H
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <new>
 #include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 
-template<typename E>
-class Node {
-    public:
-    E data;
-    int priority{};
-    Node* next;
-
-    // ==Constructor==
-    Node() = default;
-    Node(const E& d, const int p) : data(d), priority(p), next(nullptr) {}
-    Node(E&& d, const int p) : data(static_cast<E&&>(d)), priority(p), next(nullptr) {}
-    // ==Destructor==
-    ~Node() = default;
-};
+#include "allocator/allocator.h"
+#include "io/dump_writer.h"
+#include "io/snapshot.h"
+#include "priority_index.h"
+#include "stats/stats.h"
+
+/*
+ * Array-backed d-ary max-heap.
+ * Entries with equal priority leave in push order:
+ * every entry carries a sequence number used as a tie-breaker.
+ * Arity = 2 is a classic binary heap, 4 and 8 trade deeper
+ * comparisons per level for a shallower tree and fewer cache misses.
+ * The heap array comes from the Alloc policy (see allocator/allocator.h)
+ *
+ * push returns a Handle that stays valid while the element is queued.
+ * A slot table maps handles to heap positions and is updated on every
+ * move, so update_priority/erase/contains are O(log n) or O(1).
+ * A handle goes stale once its element leaves; the slot generation
+ * (odd while occupied) catches reuse of the slot by a later push.
+ *
+ * The Index policy (see priority_index.h) may keep secondary lookups
+ * for find_by_priority/contains_by_priority/find_by_value in sync.
+ * The Stats policy (see stats/stats.h) may count allocations,
+ * comparisons, sift paths and scans
+ */
 
-template<typename E>
+template<typename E, size_t Arity = 2, typename Alloc = HeapAllocator, typename Index = NoIndex,
+         typename Stats = NoStats>
 class PriorityQueue {
+    static_assert(Arity >= 2, "Heap arity must be at least 2");
+
+    public:
+    struct Handle {
+        size_t slot;
+        unsigned long long generation;
+    };
+
     private:
+    static constexpr size_t no_slot = static_cast<size_t>(-1);
+    static constexpr size_t load_chunk = 1024; // first allocation of load, in elements
+
+    struct Entry {
+        E data;
+        int priority;
+        unsigned long long seq;
+        size_t slot;
+
+        Entry(const E& d, const int p, const unsigned long long s, const size_t sl)
+            : data(d), priority(p), seq(s), slot(sl) {}
+        Entry(E&& d, const int p, const unsigned long long s, const size_t sl)
+            : data(static_cast<E&&>(d)), priority(p), seq(s), slot(sl) {}
+    };
+
+    // pos is the heap index while occupied, the next free slot otherwise
+    struct Slot {
+        size_t pos;
+        unsigned long long generation;
+    };
+
     size_t size;
-    Node<E>* head;
+    size_t capacity;
+    unsigned long long next_seq;
+    Entry* heap;
+    Slot* slots;
+    size_t slot_count; // slots ever handed out, never above capacity
+    size_t free_slot;
+    [[no_unique_address]] Alloc allocator;
+    [[no_unique_address]] Index index;
+    [[no_unique_address]] mutable Stats counters;
+
+    // Heap array and slot table, the index is not counted
+    [[nodiscard]] size_t memory_bytes() const { return capacity * (sizeof(Entry) + sizeof(Slot)); }
+
+    void free_heap() {
+        if (heap != nullptr) {
+            allocator.deallocate(heap, capacity * sizeof(Entry), alignof(Entry));
+            counters.on_free();
+        }
+        if (slots != nullptr) {
+            allocator.deallocate(slots, capacity * sizeof(Slot), alignof(Slot));
+            counters.on_free();
+        }
+    }
 
     // == Utils methods ==
-    void insert_sorted(Node<E>* newNode) {
-        if (!head || newNode->priority > head->priority) {
-            newNode->next = head;
-            head = newNode;
+    // True if a must leave the queue before b
+    static bool before(const Entry& a, const Entry& b) {
+        return a.priority > b.priority || (a.priority == b.priority && a.seq < b.seq);
+    }
+
+    void grow(const size_t min_capacity) {
+        size_t new_capacity = capacity ? capacity : 16;
+        while (new_capacity < min_capacity) new_capacity *= 2;
+
+        auto fresh = static_cast<Entry*>(allocator.allocate(new_capacity * sizeof(Entry), alignof(Entry)));
+        auto fresh_slots = static_cast<Slot*>(allocator.allocate(new_capacity * sizeof(Slot), alignof(Slot)));
+        counters.on_alloc();
+        counters.on_alloc();
+        counters.on_memory((capacity + new_capacity) * (sizeof(Entry) + sizeof(Slot)));
+        for (size_t i = 0; i < size; ++i) {
+            ::new (fresh + i) Entry(static_cast<Entry&&>(heap[i]));
+            heap[i].~Entry();
+        }
+        for (size_t i = 0; i < slot_count; ++i) fresh_slots[i] = slots[i];
+        free_heap();
+        heap = fresh;
+        slots = fresh_slots;
+        capacity = new_capacity;
+    }
+
+    size_t acquire_slot() {
+        size_t slot = free_slot;
+        if (slot != no_slot) free_slot = slots[slot].pos;
+        else slots[slot = slot_count++] = Slot{0, 0};
+        ++slots[slot].generation;
+        return slot;
+    }
+
+    void release_slot(const size_t slot) {
+        ++slots[slot].generation;
+        slots[slot].pos = free_slot;
+        free_slot = slot;
+    }
+
+    // Move-assign into position i and keep the slot table in sync
+    void place(const size_t i, Entry&& e) {
+        heap[i] = static_cast<Entry&&>(e);
+        slots[heap[i].slot].pos = i;
+    }
+
+    [[nodiscard]] size_t position(const Handle h) const {
+        if (!contains(h)) throw std::out_of_range("Invalid priority queue handle");
+        return slots[h.slot].pos;
+    }
+
+    // Sifts report the levels moved as a traversal
+    void sift_up(size_t i) {
+        Entry moving = static_cast<Entry&&>(heap[i]);
+        size_t compared = 0;
+        size_t levels = 0;
+        while (i > 0) {
+            const size_t parent = (i - 1) / Arity;
+            ++compared;
+            if (!before(moving, heap[parent])) break;
+            place(i, static_cast<Entry&&>(heap[parent]));
+            i = parent;
+            ++levels;
+        }
+        place(i, static_cast<Entry&&>(moving));
+        counters.on_compare(compared);
+        counters.on_traverse(levels);
+    }
+
+    void sift_down(size_t i) {
+        Entry moving = static_cast<Entry&&>(heap[i]);
+        size_t compared = 0;
+        size_t levels = 0;
+        while (true) {
+            const size_t first = i * Arity + 1;
+            if (first >= size) break;
+            const size_t last = first + Arity < size ? first + Arity : size;
+
+            size_t best = first;
+            for (size_t c = first + 1; c < last; ++c) {
+                if (before(heap[c], heap[best])) best = c;
+            }
+            compared += last - first;
+            if (!before(heap[best], moving)) break;
+            place(i, static_cast<Entry&&>(heap[best]));
+            i = best;
+            ++levels;
+        }
+        place(i, static_cast<Entry&&>(moving));
+        counters.on_compare(compared);
+        counters.on_traverse(levels);
+    }
+
+    // Entry at i changed its key, move it whichever way restores the heap
+    void restore(const size_t i) {
+        if (i > 0) counters.on_compare(1);
+        if (i > 0 && before(heap[i], heap[(i - 1) / Arity])) sift_up(i);
+        else sift_down(i);
+    }
+
+    template<typename T>
+    Handle emplace(T&& value, const int priority) {
+        if (size == capacity) grow(size + 1);
+        const size_t slot = acquire_slot();
+        ::new (heap + size) Entry(static_cast<T&&>(value), priority, next_seq++, slot);
+        slots[slot].pos = size;
+        ++size;
+        counters.on_size(size);
+        sift_up(size - 1);
+        if constexpr (Index::enabled) index.on_insert(slot, heap[slots[slot].pos].data, priority);
+        return Handle{slot, slots[slot].generation};
+    }
+
+    // Append (value, priority) pairs or tuples without restoring the heap
+    template<std::input_iterator It>
+    void append_range(It first, It last) {
+        if constexpr (std::forward_iterator<It>) {
+            reserve(size + static_cast<size_t>(std::distance(first, last)));
+        }
+        for (; first != last; ++first) {
+            auto&& item = *first;
+            if (size == capacity) grow(size + 1);
+            const size_t slot = acquire_slot();
+            ::new (heap + size) Entry(std::get<0>(static_cast<decltype(item)&&>(item)), std::get<1>(item),
+                                      next_seq++, slot);
+            slots[slot].pos = size;
+            if constexpr (Index::enabled) index.on_insert(slot, heap[size].data, heap[size].priority);
+            ++size;
+        }
+        counters.on_size(size);
+    }
+
+    // Floyd's bottom-up construction, O(n)
+    void heapify() {
+        if (size < 2) return;
+        for (size_t i = (size - 2) / Arity + 1; i-- > 0;) sift_down(i);
+    }
+
+    // Take the entry at i out of the heap, the hole is filled by the last entry
+    E remove_at(const size_t i) {
+        if constexpr (Index::enabled) index.on_erase(heap[i].slot, heap[i].data, heap[i].priority);
+        E res = static_cast<E&&>(heap[i].data);
+        release_slot(heap[i].slot);
+        --size;
+        if (i != size) {
+            place(i, static_cast<Entry&&>(heap[size]));
+            heap[size].~Entry();
+            restore(i);
         } else {
-            auto curr = head;
-            while (curr->next && curr->next->priority >= newNode->priority)
-                curr = curr->next;
-            newNode->next = curr->next;
-            curr->next = newNode;
+            heap[size].~Entry();
         }
+        return res;
     }
 
     void clear() {
-        while (head) {
-            auto temp = head;
-            head = head->next;
-            delete temp;
+        if constexpr (!std::is_trivially_destructible_v<Entry>) {
+            for (size_t i = 0; i < size; ++i) heap[i].~Entry();
         }
+        free_heap();
+        heap = nullptr;
+        slots = nullptr;
         size = 0;
+        capacity = 0;
+        slot_count = 0;
+        free_slot = no_slot;
+    }
+
+    // Same heap layout and slot table as other in one allocation each,
+    // so handles into other are valid for the copy too
+    void copy_from(const PriorityQueue& other) {
+        if (other.capacity == 0) return;
+        grow(other.capacity);
+        for (size_t i = 0; i < other.slot_count; ++i) slots[i] = other.slots[i];
+        slot_count = other.slot_count;
+        free_slot = other.free_slot;
+        next_seq = other.next_seq;
+        for (; size < other.size; ++size) ::new (heap + size) Entry(other.heap[size]);
+        counters.on_size(size);
+        index = other.index;
     }
 
     public:
-    // ==Constructor==
-    explicit PriorityQueue() : size(0), head(nullptr) {}
+    // Walks the heap array: the top comes first, the rest is in no
+    // particular order. priority() gives the current element's priority
+    class const_iterator {
+        private:
+        const Entry* entry = nullptr;
+
+        public:
+        using iterator_concept = std::forward_iterator_tag;
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = E;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const E*;
+        using reference = const E&;
+
+        const_iterator() = default;
+        explicit const_iterator(const Entry* e) : entry(e) {}
+
+        reference operator*() const { return entry->data; }
+        pointer operator->() const { return &entry->data; }
+        [[nodiscard]] int priority() const { return entry->priority; }
+
+        const_iterator& operator++() {
+            ++entry;
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator temp = *this;
+            ++entry;
+            return temp;
+        }
+
+        friend bool operator==(const const_iterator&, const const_iterator&) = default;
+    };
+
+    using iterator = const_iterator;
+
+    // ==Constructors==
+    explicit PriorityQueue(const Alloc& alloc = Alloc())
+        : size(0), capacity(0), next_seq(0), heap(nullptr), slots(nullptr),
+          slot_count(0), free_slot(no_slot), allocator(alloc) {}
+    // Build from a range of (value, priority) pairs in O(n),
+    // equal priorities keep range order
+    template<std::input_iterator It>
+    PriorityQueue(It first, It last, const Alloc& alloc = Alloc()) : PriorityQueue(alloc) {
+        append_range(first, last);
+        heapify();
+    }
     // ==Destructor==
     ~PriorityQueue() {
         clear();
     }
 
-    // ==Prohibit assignment==
-    PriorityQueue& operator=(const PriorityQueue&) = delete;
-    PriorityQueue(const PriorityQueue&) = delete;
-    // ==Prohibit movement==
-    PriorityQueue(PriorityQueue&&) = delete;
-    PriorityQueue& operator=(PriorityQueue&&) = delete;
+    // ==Copy==
+    // Deep copy, shares other's allocator
+    PriorityQueue(const PriorityQueue& other) : PriorityQueue(other.allocator) {
+        copy_from(other);
+    }
+
+    PriorityQueue& operator=(const PriorityQueue& other) {
+        if (this != &other) PriorityQueue(other).swap(*this);
+        return *this;
+    }
+
+    // ==Move==
+    // Takes over other's storage, other is left empty. Handles move along
+    PriorityQueue(PriorityQueue&& other) noexcept(std::is_nothrow_move_constructible_v<Index>)
+        : size(other.size), capacity(other.capacity), next_seq(other.next_seq), heap(other.heap),
+          slots(other.slots), slot_count(other.slot_count), free_slot(other.free_slot),
+          allocator(other.allocator), index(static_cast<Index&&>(other.index)) {
+        other.heap = nullptr;
+        other.slots = nullptr;
+        other.size = 0;
+        other.capacity = 0;
+        other.slot_count = 0;
+        other.free_slot = no_slot;
+        other.index = Index();
+    }
+
+    PriorityQueue& operator=(PriorityQueue&& other) noexcept(std::is_nothrow_swappable_v<Index> &&
+                                                              std::is_nothrow_move_constructible_v<Index>) {
+        if (this != &other) PriorityQueue(static_cast<PriorityQueue&&>(other)).swap(*this);
+        return *this;
+    }
+
+    void swap(PriorityQueue& other) noexcept(std::is_nothrow_swappable_v<Index>) {
+        std::swap(size, other.size);
+        std::swap(capacity, other.capacity);
+        std::swap(next_seq, other.next_seq);
+        std::swap(heap, other.heap);
+        std::swap(slots, other.slots);
+        std::swap(slot_count, other.slot_count);
+        std::swap(free_slot, other.free_slot);
+        std::swap(allocator, other.allocator);
+        std::swap(index, other.index);
+    }
+
+    friend void swap(PriorityQueue& a, PriorityQueue& b) noexcept(noexcept(a.swap(b))) { a.swap(b); }
 
     // ==Basic operations==
     [[nodiscard]] bool is_empty() const { return size == 0; }
 
     [[nodiscard]] size_t get_size() const { return size; }
 
+    // Preallocate storage for n elements
+    void reserve(const size_t n) {
+        if (n > capacity) grow(n);
+    }
 
     [[maybe_unused]] const E& top() const {
         if (is_empty()) throw std::out_of_range("Priority queue is empty");
-        return head->data;
+        return heap[0].data;
     }
 
     [[nodiscard]] int top_priority() const {
         if (is_empty()) throw std::out_of_range("Priority queue is empty");
-        return head->priority;
+        return heap[0].priority;
     }
 
-    void push(E&& value, int priority) {
-        auto newNode = new Node<E>(static_cast<E&&>(value), priority);
-        insert_sorted(newNode);
-        ++size;
+    Handle push(E&& value, int priority) {
+        return emplace(static_cast<E&&>(value), priority);
     }
 
-    void push(const E& value, int priority) {
-        auto newNode = new Node<E>(value, priority);
-        insert_sorted(newNode);
-        ++size;
+    Handle push(const E& value, int priority) {
+        return emplace(value, priority);
     }
 
     E pop() {
         if (is_empty()) throw std::out_of_range("Priority queue is empty");
+        return remove_at(0);
+    }
 
-        auto temp = head;
-        E res = static_cast<E&&>(temp->data);
+    // == Bulk operations ==
+    // Append a batch of (value, priority) pairs. A batch at least as large
+    // as the queue is heapified in one O(n) pass instead of k sift-ups
+    template<std::input_iterator It>
+    void push_range(It first, It last) {
+        const size_t old_size = size;
+        append_range(first, last);
+        if (size - old_size >= old_size) heapify();
+        else for (size_t i = old_size; i < size; ++i) sift_up(i);
+    }
 
-        head = head->next;
-        delete temp;
-        --size;
+    // Replace the contents, storage is reused. Handles to old elements go stale
+    template<std::input_iterator It>
+    void assign(It first, It last) {
+        for (size_t i = 0; i < size; ++i) {
+            release_slot(heap[i].slot);
+            heap[i].~Entry();
+        }
+        size = 0;
+        index = Index();
+        append_range(first, last);
+        heapify();
+    }
 
-        return res;
+    // == Handle operations ==
+    [[nodiscard]] Handle top_handle() const {
+        if (is_empty()) throw std::out_of_range("Priority queue is empty");
+        return Handle{heap[0].slot, slots[heap[0].slot].generation};
+    }
+
+    // True while the element behind h is still queued
+    [[nodiscard]] bool contains(const Handle h) const {
+        return h.slot < slot_count && slots[h.slot].generation == h.generation;
     }
 
+    [[nodiscard]] const E& get(const Handle h) const { return heap[position(h)].data; }
+
+    [[nodiscard]] int get_priority(const Handle h) const { return heap[position(h)].priority; }
+
+    // The element queues as if pushed now with the new priority
+    void update_priority(const Handle h, const int priority) {
+        const size_t i = position(h);
+        if constexpr (Index::enabled) {
+            index.on_erase(h.slot, heap[i].data, heap[i].priority);
+            index.on_insert(h.slot, heap[i].data, priority);
+        }
+        heap[i].priority = priority;
+        heap[i].seq = next_seq++;
+        restore(i);
+    }
+
+    E erase(const Handle h) {
+        return remove_at(position(h));
+    }
+
+    // Heap order says nothing about equal priorities,
+    // so the earliest pushed match is picked explicitly
     E find_by_priority(const int& prior) const {
-        auto curr = head;
-        while (curr) {
-            if (curr->priority == prior) return curr->data;
-            curr = curr->next;
+        if constexpr (Index::enabled) {
+            const size_t slot = index.first_with_priority(prior);
+            if (slot == Index::none) throw std::out_of_range("Element with specified priority not found");
+            return heap[slots[slot].pos].data;
+        }
+        const Entry* found = nullptr;
+        for (size_t i = 0; i < size; ++i) {
+            if (heap[i].priority == prior && (!found || heap[i].seq < found->seq)) found = &heap[i];
         }
-        throw std::out_of_range("Element with specified priority not found");
+        counters.on_compare(size);
+        counters.on_traverse(size);
+        if (!found) throw std::out_of_range("Element with specified priority not found");
+        return found->data;
     }
 
     [[nodiscard]] bool contains_by_priority(const int prior) const {
-        auto curr = head;
-        while (curr) {
-            if (curr->priority == prior) return true;
-            curr = curr->next;
+        if constexpr (Index::enabled) return index.contains_priority(prior);
+        for (size_t i = 0; i < size; ++i) {
+            if (heap[i].priority == prior) {
+                counters.on_compare(i + 1);
+                counters.on_traverse(i + 1);
+                return true;
+            }
         }
+        counters.on_compare(size);
+        counters.on_traverse(size);
         return false;
     }
 
+    // Priority of the match that would be popped first
     int find_by_value(const E& value) const {
-        auto curr = head;
-        while (curr) {
-            if (curr->data == value) return curr->priority;
-            curr = curr->next;
+        const Entry* found = nullptr;
+        if constexpr (Index::enabled) {
+            size_t candidates = 0;
+            index.for_each_with_value(value, [&](const size_t slot) {
+                const Entry& e = heap[slots[slot].pos];
+                if (!found || before(e, *found)) found = &e;
+                ++candidates;
+            });
+            counters.on_compare(candidates);
+            counters.on_traverse(candidates);
+            return found ? found->priority : -1;
         }
-        return -1;
+        for (size_t i = 0; i < size; ++i) {
+            if (heap[i].data == value && (!found || before(heap[i], *found))) found = &heap[i];
+        }
+        counters.on_compare(size);
+        counters.on_traverse(size);
+        return found ? found->priority : -1;
+    }
+
+    // ==Statistics (see stats/stats.h)==
+    [[nodiscard]] ContainerStats stats() const requires Stats::enabled { return counters.snapshot(memory_bytes()); }
+
+    void reset_stats() requires Stats::enabled { counters.reset(size, memory_bytes()); }
+
+    // ==Traversal==
+    [[nodiscard]] const_iterator begin() const { return const_iterator(heap); }
+    [[nodiscard]] const_iterator end() const { return const_iterator(heap + size); }
+    [[nodiscard]] const_iterator cbegin() const { return begin(); }
+    [[nodiscard]] const_iterator cend() const { return end(); }
+
+    // ==Output==
+    // Up to limit elements as value(priority) in pop order, a cut is marked with "...".
+    // Only the shown prefix is sorted, the heap itself is left untouched
+    void dump(DumpWriter& out, const size_t limit = DumpWriter::no_limit) const {
+        const size_t shown = limit < size ? limit : size;
+        const std::unique_ptr<const Entry*[]> order(new const Entry*[size]);
+        for (size_t i = 0; i < size; ++i) order[i] = &heap[i];
+        std::partial_sort(order.get(), order.get() + shown, order.get() + size,
+                          [](const Entry* a, const Entry* b) { return before(*a, *b); });
+        for (size_t i = 0; i < shown; ++i) out << order[i]->data << '(' << order[i]->priority << ") ";
+        if (shown < size) out << "... (" << size - shown << " more)";
+    }
+
+    void dump(std::ostream& os, const size_t limit = DumpWriter::no_limit) const {
+        DumpWriter out(os);
+        dump(out, limit);
+    }
+
+    void dump_to(const int fd, const size_t limit = DumpWriter::no_limit) const {
+        DumpWriter out(fd);
+        dump(out, limit);
+    }
+
+    // ==Snapshots (see io/snapshot.h)==
+    // Header, next sequence number, then three columns in heap order:
+    // elements, priorities (i32), sequence numbers (u64)
+    void save(std::ostream& os) const {
+        Snapshot::Writer w(os);
+        Snapshot::write_header<E>(w, Snapshot::Kind::PRIORITY_QUEUE, size);
+        w.put(static_cast<uint64_t>(next_seq));
+        for (size_t i = 0; i < size; ++i) SnapshotCodec<E>::write(w, &heap[i].data, 1);
+        for (size_t i = 0; i < size; ++i) w.put(static_cast<int32_t>(heap[i].priority));
+        for (size_t i = 0; i < size; ++i) w.put(static_cast<uint64_t>(heap[i].seq));
+    }
+
+    // Replace the contents. Entries go back to their saved heap positions,
+    // one O(n) check confirms the heap order and only a foreign layout
+    // (another arity) is heapified. Handles are renumbered, old ones go stale.
+    // Storage grows with the elements actually read, not the header count.
+    // The queue is left unchanged if the snapshot is bad
+    void load(std::istream& is) {
+        Snapshot::Reader r(is);
+        const uint64_t header_count = Snapshot::read_header<E>(r, Snapshot::Kind::PRIORITY_QUEUE);
+        PriorityQueue fresh(allocator);
+        fresh.next_seq = r.get<uint64_t>();
+        alignas(E) unsigned char raw[sizeof(E)];
+        auto value = reinterpret_cast<E*>(raw);
+        for (; fresh.size < header_count; ++fresh.size) {
+            if (fresh.size == fresh.capacity) fresh.grow(fresh.size < load_chunk ? load_chunk : fresh.size + 1);
+            SnapshotCodec<E>::read(r, value, 1);
+            ::new (fresh.heap + fresh.size) Entry(static_cast<E&&>(*value), 0, 0, fresh.size);
+            value->~E();
+            fresh.slots[fresh.size] = Slot{fresh.size, 1};
+            fresh.slot_count = fresh.size + 1;
+        }
+        const size_t count = fresh.size;
+        for (size_t i = 0; i < count; ++i) fresh.heap[i].priority = r.get<int32_t>();
+        for (size_t i = 0; i < count; ++i) {
+            fresh.heap[i].seq = r.get<uint64_t>();
+            if (fresh.heap[i].seq >= fresh.next_seq) fresh.next_seq = fresh.heap[i].seq + 1;
+        }
+        for (size_t i = 1; i < count; ++i) {
+            if (before(fresh.heap[i], fresh.heap[(i - 1) / Arity])) {
+                fresh.heapify();
+                break;
+            }
+        }
+        if constexpr (Index::enabled) {
+            // The index keeps equal keys in push order
+            const std::unique_ptr<const Entry*[]> order(new const Entry*[count]);
+            for (size_t i = 0; i < count; ++i) order[i] = &fresh.heap[i];
+            std::sort(order.get(), order.get() + count, [](const Entry* a, const Entry* b) { return a->seq < b->seq; });
+            for (size_t i = 0; i < count; ++i) fresh.index.on_insert(order[i]->slot, order[i]->data, order[i]->priority);
+        }
+        swap(fresh);
+    }
+
+    void save(const std::filesystem::path& path) const {
+        Snapshot::save_file(path, [this](std::ostream& os) { save(os); });
+    }
+
+    void load(const std::filesystem::path& path) {
+        Snapshot::load_file(path, [this](std::istream& is) { load(is); });
     }
 
     void peek_pq() const {
         if (is_empty()) throw std::out_of_range("Priority queue is empty");
-        for (auto curr = head; curr != nullptr; curr = curr->next) {
-            std::cout << curr->data << "(" << curr->priority << ") ";
-        }
+        dump(std::cout);
     }
 };
 
-#endif
\ No newline at end of file
+// Shallower heaps for large queues
+template<typename E, typename Alloc = HeapAllocator>
+using QuaternaryPriorityQueue = PriorityQueue<E, 4, Alloc>;
+template<typename E, typename Alloc = HeapAllocator>
+using OctonaryPriorityQueue = PriorityQueue<E, 8, Alloc>;
+
+// Hash-indexed lookups, E must be hashable
+template<typename E, size_t Arity = 2, typename Alloc = HeapAllocator>
+using IndexedPriorityQueue = PriorityQueue<E, Arity, Alloc, HashIndex<E>>;
+
+#endif
@@ -0,0 +1,101 @@
+#include <cassert>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include "priority_q/external_priority_q.h"
+#include "priority_q/priority_q.h"
+#include "test_priority_q.h"
+
+void run_tests_external_priority_q() {
+    std::cout << "=== Running External Priority Queue Tests ===" << std::endl;
+    const auto directory = std::filesystem::temp_directory_path() / "lab3_external_pq_test";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    // Test 1: Same order as PriorityQueue, FIFO within a priority across runs
+    std::cout << "Test 1: Order across runs... ";
+    {
+        ExternalPriorityQueue<std::string> pq(32, directory);
+        PriorityQueue<std::string> reference;
+        assert(pq.is_empty());
+        for (int i = 0; i < 500; ++i) {
+            const std::string value = "item " + std::to_string(i);
+            pq.push(value, i % 3);
+            reference.push(value, i % 3);
+            assert(pq.get_in_memory() <= pq.get_budget());
+        }
+        assert(pq.get_size() == 500);
+        assert(pq.get_run_count() > 0);
+        assert(pq.get_on_disk() > 0);
+        assert(pq.top() == "item 2");
+        assert(pq.top_priority() == 2);
+        while (!reference.is_empty()) {
+            assert(pq.top_priority() == reference.top_priority());
+            [[maybe_unused]] const std::string got = pq.pop();
+            [[maybe_unused]] const std::string want = reference.pop();
+            assert(got == want);
+            assert(pq.get_in_memory() <= pq.get_budget());
+        }
+        assert(pq.is_empty());
+        assert(pq.get_run_count() == 0);
+        try {
+            pq.pop();
+            assert(false);
+        } catch (const std::out_of_range&) {}
+        try {
+            (void)pq.top_priority();
+            assert(false);
+        } catch (const std::out_of_range&) {}
+    }
+    assert(std::filesystem::is_empty(directory));
+    std::cout << "PASSED" << std::endl;
+
+    // Test 2: Random pushes and pops, enough flushes to merge runs in tiers
+    std::cout << "Test 2: Random operations against PriorityQueue... ";
+    {
+        ExternalPriorityQueue<int> pq(64, directory);
+        PriorityQueue<int> reference;
+        std::mt19937 gen(7);
+        std::uniform_int_distribution<> prio(0, 1000);
+        int next = 0;
+        for (int round = 0; round < 100; ++round) {
+            for (int i = 0; i < 300; ++i) {
+                const int p = prio(gen);
+                pq.push(next, p);
+                reference.push(next++, p);
+            }
+            for (int i = 0; i < 100; ++i) {
+                [[maybe_unused]] const int got = pq.pop();
+                [[maybe_unused]] const int want = reference.pop();
+                assert(got == want);
+            }
+            assert(pq.get_run_count() < ExternalPriorityQueue<int>::max_runs);
+            assert(pq.get_in_memory() <= pq.get_budget());
+        }
+        assert(pq.get_size() == reference.get_size());
+        while (!reference.is_empty()) {
+            [[maybe_unused]] const int got = pq.pop();
+            [[maybe_unused]] const int want = reference.pop();
+            assert(got == want);
+        }
+        assert(pq.is_empty());
+    }
+    assert(std::filesystem::is_empty(directory));
+    std::cout << "PASSED" << std::endl;
+
+    // Test 3: Runs still on disk are deleted with the queue
+    std::cout << "Test 3: Cleanup... ";
+    {
+        ExternalPriorityQueue<int> pq(32, directory);
+        for (int i = 0; i < 1000; ++i) pq.push(i, i % 10);
+        assert(pq.pop() == 9);
+        assert(!std::filesystem::is_empty(directory));
+    }
+    assert(std::filesystem::is_empty(directory));
+    std::filesystem::remove_all(directory);
+    std::cout << "PASSED" << std::endl;
+
+    std::cout << "\n=== All External Priority Queue tests PASSED! ===" << std::endl;
+}
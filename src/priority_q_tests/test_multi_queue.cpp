@@ -0,0 +1,78 @@
+#include <cassert>
+#include <climits>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "priority_q/multi_queue.h"
+#include "test_priority_q.h"
+
+void run_tests_multi_queue() {
+    std::cout << "=== Running MultiQueue Tests ===" << std::endl;
+
+    // Test 1: A single shard behaves like PriorityQueue
+    std::cout << "Test 1: Exact order with one shard... ";
+    MultiQueue<std::string> exact(1, 1);
+    assert(exact.get_shard_count() == 1);
+    assert(exact.is_empty());
+    exact.push("low", 1);
+    exact.push("high", 9);
+    exact.push("mid", 5);
+    exact.push("mid2", 5);
+    assert(exact.get_size() == 4);
+    assert(exact.top_priority() == 9);
+    assert(exact.pop() == "high");
+    assert(exact.pop() == "mid");
+    assert(exact.pop() == "mid2");
+    assert(exact.pop() == "low");
+
+    try {
+        exact.pop();
+        assert(false); // Should not reach here
+    } catch (const std::out_of_range& e) {
+        assert(std::string(e.what()) == "Priority queue is empty");
+    }
+    std::cout << "PASSED" << std::endl;
+
+    // Test 2: Relaxed order still drains everything, including INT_MIN priorities
+    std::cout << "Test 2: Relaxed drain... ";
+    MultiQueue<int> relaxed(4, 2);
+    for (int i = 0; i < 1000; ++i) relaxed.push(i, i % 2 ? i : INT_MIN);
+    int value;
+    int popped = 0;
+    while (relaxed.try_pop(value)) ++popped;
+    assert(popped == 1000);
+    assert(relaxed.is_empty());
+    std::cout << "PASSED" << std::endl;
+
+    // Test 3: Concurrent producers and consumers
+    std::cout << "Test 3: Multi-threaded push/pop... ";
+    const unsigned hw = std::thread::hardware_concurrency();
+    const int threads = hw < 2 ? 2 : (hw > 8 ? 8 : static_cast<int>(hw));
+    constexpr int PER_THREAD = 20000;
+
+    MultiQueue<int> shared(threads);
+    std::vector<std::vector<int>> taken(threads);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&shared, &taken, t] {
+            int v;
+            for (int i = 0; i < PER_THREAD; ++i) {
+                const int id = t * PER_THREAD + i;
+                shared.push(id, id % 97);
+                if (i % 2 == 1 && shared.try_pop(v)) taken[t].push_back(v);
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    std::vector<int> seen(threads * PER_THREAD, 0);
+    for (const auto& values : taken) {
+        for (const int v : values) ++seen[v];
+    }
+    while (shared.try_pop(value)) ++seen[value];
+    for (const int count : seen) assert(count == 1);
+    std::cout << "PASSED" << std::endl;
+
+    std::cout << "\n=== All MultiQueue tests PASSED! ===" << std::endl;
+}
@@ -0,0 +1,135 @@
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "allocator/allocator.h"
+#include "priority_q/pairing_priority_q.h"
+#include "priority_q/priority_q.h"
+#include "test_priority_q.h"
+
+void run_tests_pairing_priority_q() {
+    std::cout << "=== Running PairingPriorityQueue Tests ===" << std::endl;
+
+    // Test 1: Same pop order as PriorityQueue, FIFO within a priority
+    std::cout << "Test 1: Basic operations... ";
+    PairingPriorityQueue<std::string> pq;
+    assert(pq.is_empty());
+    pq.push("low", 1);
+    pq.push("high", 9);
+    pq.push("mid", 5);
+    pq.push("mid2", 5);
+    assert(pq.get_size() == 4);
+    assert(pq.top() == "high");
+    assert(pq.top_priority() == 9);
+    assert(pq.find_by_priority(5) == "mid");
+    assert(pq.contains_by_priority(1));
+    assert(!pq.contains_by_priority(7));
+    assert(pq.find_by_value("mid2") == 5);
+    assert(pq.find_by_value("none") == -1);
+    std::ostringstream dumped;
+    pq.dump(dumped, 3);
+    assert(dumped.str() == "high(9) mid(5) mid2(5) ... (1 more)");
+    assert(pq.pop() == "high");
+    assert(pq.pop() == "mid");
+    assert(pq.pop() == "mid2");
+    assert(pq.pop() == "low");
+
+    try {
+        pq.pop();
+        assert(false);
+    } catch (const std::out_of_range&) {}
+    std::cout << "PASSED" << std::endl;
+
+    // Test 2: Merge keeps global order and push order across queues
+    std::cout << "Test 2: Merge... ";
+    PairingPriorityQueue<std::string> left, right;
+    left.push("a", 3);
+    right.push("b", 3);
+    left.push("c", 3);
+    right.push("d", 8);
+    left.merge(static_cast<PairingPriorityQueue<std::string>&&>(right));
+    assert(right.is_empty());
+    assert(right.get_size() == 0);
+    assert(left.get_size() == 4);
+    assert(left.pop() == "d");
+    assert(left.pop() == "a");
+    assert(left.pop() == "b");
+    assert(left.pop() == "c");
+    left.merge(static_cast<PairingPriorityQueue<std::string>&&>(right));
+    assert(left.is_empty());
+    right.push("e", 1);
+    std::cout << "PASSED" << std::endl;
+
+    // Test 3: Matches PriorityQueue on random pushes, pops and merges
+    std::cout << "Test 3: Random operations against PriorityQueue... ";
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<> prio(0, 50);
+    PriorityQueue<int> reference;
+    PairingPriorityQueue<int> merged;
+    int next = 0;
+    for (int round = 0; round < 50; ++round) {
+        PairingPriorityQueue<int> batch;
+        for (int i = 0; i < 40; ++i) {
+            const int p = prio(gen);
+            reference.push(next, p);
+            batch.push(next++, p);
+        }
+        merged.merge(static_cast<PairingPriorityQueue<int>&&>(batch));
+        for (int i = 0; i < 15; ++i) {
+            [[maybe_unused]] const int got = merged.pop();
+            [[maybe_unused]] const int want = reference.pop();
+            assert(got == want);
+        }
+    }
+    assert(merged.get_size() == reference.get_size());
+    while (!reference.is_empty()) {
+        [[maybe_unused]] const int got = merged.pop();
+        [[maybe_unused]] const int want = reference.pop();
+        assert(got == want);
+    }
+    assert(merged.is_empty());
+    std::cout << "PASSED" << std::endl;
+
+    // Test 4: Merge between different pools copies nodes, same pool links roots
+    std::cout << "Test 4: Merge with pool allocators... ";
+    Pool pool_a, pool_b;
+    {
+        PairingPriorityQueue<std::string, PoolAllocator> a{PoolAllocator(pool_a)};
+        PairingPriorityQueue<std::string, PoolAllocator> b{PoolAllocator(pool_b)};
+        PairingPriorityQueue<std::string, PoolAllocator> c{PoolAllocator(pool_a)};
+        for (int i = 0; i < 100; ++i) {
+            a.push("a" + std::to_string(i), i % 7);
+            b.push("b" + std::to_string(i), i % 5);
+            c.push("c" + std::to_string(i), i % 3);
+        }
+        a.merge(static_cast<PairingPriorityQueue<std::string, PoolAllocator>&&>(b));
+        a.merge(static_cast<PairingPriorityQueue<std::string, PoolAllocator>&&>(c));
+        assert(a.get_size() == 300);
+        assert(b.is_empty() && c.is_empty());
+        b.push("reuse", 1);
+        int last = a.top_priority();
+        while (!a.is_empty()) {
+            assert(a.top_priority() <= last);
+            last = a.top_priority();
+            a.pop();
+        }
+    }
+    std::cout << "PASSED" << std::endl;
+
+    // Test 5: Deep heap, destructor and pops must not recurse
+    std::cout << "Test 5: Large heap... ";
+    {
+        PairingPriorityQueue<int> deep;
+        for (int i = 0; i < 200000; ++i) deep.push(i, i);
+        assert(deep.pop() == 199999);
+        std::vector<int> values;
+        for (int i = 0; i < 1000; ++i) values.push_back(deep.pop());
+        for (size_t i = 1; i < values.size(); ++i) assert(values[i - 1] > values[i]);
+    }
+    std::cout << "PASSED" << std::endl;
+
+    std::cout << "\n=== All PairingPriorityQueue tests PASSED! ===" << std::endl;
+}
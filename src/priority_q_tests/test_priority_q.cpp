@@ -1,10 +1,21 @@
 //
 // Created by IWOFLEUR on 19.09.2025.
 //
+#include <algorithm>
 #include <cassert>
+#include <filesystem>
 #include <iostream>
+#include <iterator>
+#include <ranges>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "io/dump_writer.h"
 #include "priority_q/priority_q.h"
+#include "stats/stats.h"
 #include "test_priority_q.h"
 
 void run_demo_priority_q() {
@@ -44,9 +55,14 @@ void run_demo_priority_q() {
         std::cout << "Value 7 has priority: " << priority << std::endl;
     }
 
+    std::cout << "Contents: ";
+    pq.dump(std::cout);
+    std::cout << std::endl;
+
     std::cout << "\nExtracting all elements (highest priority first):" << std::endl;
+    DumpWriter out(std::cout);
     while (!pq.is_empty()) {
-        std::cout << "Popped: " << pq.pop() << std::endl;
+        out << "Popped: " << pq.pop() << '\n';
     }
 }
 
@@ -225,5 +241,345 @@ void run_tests_priority_q() {
     assert(pq9.is_empty());
     std::cout << "PASSED" << std::endl;
 
+    // Test 11: d-ary heaps keep priority order and FIFO within a priority
+    std::cout << "Test 11: 4-ary and 8-ary heaps... ";
+    QuaternaryPriorityQueue<int> pq10;
+    OctonaryPriorityQueue<int> pq11;
+
+    unsigned seed = 12345;
+    for (int i = 0; i < NUM_ELEMENTS; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        const int prior = static_cast<int>((seed >> 16) % 50);
+        pq10.push(i, prior);
+        pq11.push(i, prior);
+    }
+
+    int last_prior = pq10.top_priority();
+    int last_value = -1;
+    while (!pq10.is_empty()) {
+        const int prior = pq10.top_priority();
+        assert(pq11.top_priority() == prior);
+        const int value = pq10.pop();
+        assert(pq11.pop() == value);
+        assert(prior <= last_prior);
+        if (prior == last_prior) assert(value > last_value);  // Same priority keeps push order
+        last_prior = prior;
+        last_value = value;
+    }
+    assert(pq11.is_empty());
+    std::cout << "PASSED" << std::endl;
+
+    // Test 12: Handles, update_priority and erase
+    std::cout << "Test 12: Handles... ";
+    PriorityQueue<std::string> pq15;
+    const auto a = pq15.push("a", 1);
+    const auto b = pq15.push("b", 2);
+    const auto c = pq15.push("c", 3);
+    assert(pq15.contains(a) && pq15.contains(b) && pq15.contains(c));
+    assert(pq15.get(b) == "b" && pq15.get_priority(b) == 2);
+
+    pq15.update_priority(a, 10);  // Increase key
+    assert(pq15.top() == "a");
+    assert(pq15.top_handle().slot == a.slot);
+    pq15.update_priority(a, 0);   // Decrease key
+    assert(pq15.top() == "c");
+    pq15.update_priority(b, 3);   // Same priority as c, queued after it
+    assert(pq15.erase(c) == "c");
+    assert(!pq15.contains(c));
+    assert(pq15.get_size() == 2);
+
+    const auto d = pq15.push("d", 5);  // May reuse c's slot
+    assert(!pq15.contains(c));
+    assert(pq15.contains(d));
+    try {
+        pq15.erase(c);
+        assert(false); // Should not reach here
+    } catch (const std::out_of_range& e) {
+        assert(std::string(e.what()) == "Invalid priority queue handle");
+    }
+    assert(pq15.pop() == "d");
+    assert(pq15.pop() == "b");
+    assert(!pq15.contains(b));
+    assert(pq15.pop() == "a");
+    assert(pq15.is_empty());
+
+    // Random updates and erasures against a brute-force reference
+    QuaternaryPriorityQueue<int> pq16;
+    QuaternaryPriorityQueue<int>::Handle handles[NUM_ELEMENTS];
+    int reference[NUM_ELEMENTS];  // Current priority, -1 once erased
+    for (int i = 0; i < NUM_ELEMENTS; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        reference[i] = static_cast<int>((seed >> 16) % 1000);
+        handles[i] = pq16.push(i, reference[i]);
+    }
+    for (int i = 0; i < NUM_ELEMENTS; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        const auto h = handles[i];
+        if (seed % 5 == 0) {
+            assert(pq16.erase(h) == i);
+            reference[i] = -1;
+        } else if (seed % 2 == 0) {
+            reference[i] = static_cast<int>((seed >> 16) % 1000);
+            pq16.update_priority(h, reference[i]);
+        }
+    }
+    int last = 1000;
+    while (!pq16.is_empty()) {
+        const int prior = pq16.top_priority();
+        const int value = pq16.pop();
+        assert(reference[value] == prior);
+        assert(prior <= last);
+        reference[value] = -1;
+        last = prior;
+    }
+    for (const int prior : reference) assert(prior == -1);
+    std::cout << "PASSED" << std::endl;
+
+    // Test 13: Hash index gives the same answers as the linear scans
+    std::cout << "Test 13: Indexed lookups... ";
+    PriorityQueue<int> plain;
+    IndexedPriorityQueue<int> indexed;
+    PriorityQueue<int>::Handle plain_handles[NUM_ELEMENTS];
+    IndexedPriorityQueue<int>::Handle indexed_handles[NUM_ELEMENTS];
+    for (int i = 0; i < NUM_ELEMENTS; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        const int value = static_cast<int>((seed >> 16) % 300);  // Plenty of duplicate values
+        const int prior = static_cast<int>((seed >> 8) % 100);
+        plain_handles[i] = plain.push(value, prior);
+        indexed_handles[i] = indexed.push(value, prior);
+    }
+    for (int i = 0; i < NUM_ELEMENTS; i += 7) {
+        plain.update_priority(plain_handles[i], i % 100);
+        indexed.update_priority(indexed_handles[i], i % 100);
+    }
+    for (int i = 3; i < NUM_ELEMENTS; i += 11) {
+        if (!plain.contains(plain_handles[i])) continue;
+        assert(plain.erase(plain_handles[i]) == indexed.erase(indexed_handles[i]));
+    }
+
+    while (!plain.is_empty()) {
+        for (int prior = 0; prior < 100; prior += 9) {
+            assert(plain.contains_by_priority(prior) == indexed.contains_by_priority(prior));
+            if (plain.contains_by_priority(prior)) {
+                assert(plain.find_by_priority(prior) == indexed.find_by_priority(prior));
+            }
+        }
+        for (int value = 0; value < 300; value += 13) {
+            assert(plain.find_by_value(value) == indexed.find_by_value(value));
+        }
+        for (int i = 0; i < 50 && !plain.is_empty(); ++i) assert(plain.pop() == indexed.pop());
+    }
+    assert(indexed.is_empty());
+    assert(!indexed.contains_by_priority(0));
+    assert(indexed.find_by_value(0) == -1);
+    std::cout << "PASSED" << std::endl;
+
+    // Test 14: Bulk construction, push_range and assign
+    std::cout << "Test 14: Bulk construction... ";
+    static_assert(!std::is_constructible_v<PriorityQueue<int>, int, int>);  // Only iterator pairs
+    std::vector<std::pair<int, int>> batch;
+    for (int i = 0; i < NUM_ELEMENTS; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        batch.emplace_back(i, static_cast<int>((seed >> 16) % 40));
+    }
+
+    PriorityQueue<int> one_by_one;
+    for (const auto& [value, prior] : batch) one_by_one.push(value, prior);
+    OctonaryPriorityQueue<int> bulk(batch.begin(), batch.end());
+    assert(bulk.get_size() == batch.size());
+    while (!one_by_one.is_empty()) {
+        assert(bulk.top_priority() == one_by_one.top_priority());
+        assert(bulk.pop() == one_by_one.pop());  // Same order, FIFO ties included
+    }
+    assert(bulk.is_empty());
+
+    // Small batch goes through sift-ups, large batch through heapify
+    IndexedPriorityQueue<std::string> appended;
+    const std::pair<std::string, int> small[] = {{"x", 5}, {"y", 7}};
+    appended.push_range(std::begin(small), std::end(small));
+    appended.push_range(std::begin(small), std::begin(small) + 1);
+    std::vector<std::pair<std::string, int>> large;
+    for (int i = 0; i < 100; ++i) large.emplace_back(std::to_string(i), i % 5);
+    appended.push_range(std::make_move_iterator(large.begin()), std::make_move_iterator(large.end()));
+    assert(appended.get_size() == 103);
+    assert(appended.pop() == "y");
+    assert(appended.pop() == "x");
+    assert(appended.pop() == "x");
+    assert(appended.pop() == "4");
+    assert(appended.find_by_priority(4) == "9");
+
+    const auto stale = appended.top_handle();
+    appended.assign(std::begin(small), std::end(small));
+    assert(!appended.contains(stale));
+    assert(appended.get_size() == 2);
+    assert(!appended.contains_by_priority(4));
+    assert(appended.find_by_value("x") == 5);
+    assert(appended.pop() == "y");
+    std::cout << "PASSED" << std::endl;
+
+    // Test 15: Copy, move and swap
+    std::cout << "Test 15: Copy, move and swap... ";
+    static_assert(std::is_nothrow_move_constructible_v<PriorityQueue<std::string>>);
+    static_assert(std::is_nothrow_move_assignable_v<PriorityQueue<std::string>>);
+    PriorityQueue<std::string> source;
+    source.push("a", 2);
+    const auto hb = source.push("b", 5);
+    source.push("c", 2);
+    const auto hd = source.push("d", 1);
+    source.erase(hd);  // Leaves a free slot behind
+
+    PriorityQueue<std::string> copied(source);
+    assert(copied.get_size() == 3);
+    assert(copied.get(hb) == "b");  // Handles carry over to the copy
+    copied.update_priority(hb, 0);
+    assert(source.top() == "b");
+    copied.push("e", 2);  // Reuses the free slot, after "a" and "c"
+    assert(copied.pop() == "a");
+    assert(copied.pop() == "c");
+    assert(copied.pop() == "e");
+
+    PriorityQueue<std::string> moved(std::move(source));
+    assert(source.is_empty());
+    assert(moved.contains(hb));
+    source.push("f", 9);
+    swap(source, moved);
+    assert(moved.pop() == "f");
+    moved = std::move(source);
+    copied = moved;
+    assert(moved.pop() == "b" && copied.pop() == "b");
+
+    IndexedPriorityQueue<int> indexed_source;
+    for (int i = 0; i < 100; ++i) indexed_source.push(i, i % 10);
+    IndexedPriorityQueue<int> indexed_copy(indexed_source);
+    indexed_source.pop();
+    assert(indexed_copy.find_by_priority(9) == 9);  // Copy owns its index
+    assert(indexed_source.find_by_priority(9) == 19);
+    std::cout << "PASSED" << std::endl;
+
+    // Test 16: Iterators and ranges
+    std::cout << "Test 16: Iterators and ranges... ";
+    static_assert(std::forward_iterator<PriorityQueue<int>::const_iterator>);
+    static_assert(std::ranges::forward_range<const IndexedPriorityQueue<std::string>>);
+    PriorityQueue<int> walked;
+    assert(walked.begin() == walked.end());
+    for (int i = 0; i < 100; ++i) walked.push(i, i % 10);
+    assert(*walked.begin() == walked.top());  // Heap order starts at the top
+    assert(walked.begin().priority() == 9);
+    assert(std::ranges::distance(walked) == 100);
+    std::vector<int> values(walked.begin(), walked.end());
+    std::ranges::sort(values);
+    for (int i = 0; i < 100; ++i) assert(values[i] == i);
+    int priority_sum = 0;
+    for (auto it = walked.begin(); it != walked.end(); ++it) {
+        assert(it.priority() == *it % 10);
+        priority_sum += it.priority();
+    }
+    assert(priority_sum == 450);
+    assert(walked.get_size() == 100);  // Nothing was popped
+    std::cout << "PASSED" << std::endl;
+
+    // Test 17: Buffered dump in pop order
+    std::cout << "Test 17: Dump... ";
+    PriorityQueue<std::string> named;
+    named.push("low", 1);
+    named.push("high", 9);
+    named.push("mid", 5);
+    named.push("mid2", 5);
+    std::ostringstream dumped;
+    named.dump(dumped);
+    assert(dumped.str() == "high(9) mid(5) mid2(5) low(1) ");
+    dumped.str("");
+    named.dump(dumped, 2);
+    assert(dumped.str() == "high(9) mid(5) ... (2 more)");
+    assert(named.get_size() == 4);
+
+    std::ostringstream big;
+    walked.dump(big, 10);
+    std::ostringstream expected_prefix;
+    PriorityQueue<int> drained(walked);
+    for (int i = 0; i < 10; ++i) {
+        const int prior = drained.top_priority();
+        expected_prefix << drained.pop() << '(' << prior << ") ";
+    }
+    expected_prefix << "... (90 more)";
+    assert(big.str() == expected_prefix.str());
+    std::cout << "PASSED" << std::endl;
+
+    // Test 18: Binary snapshots
+    std::cout << "Test 18: Save and load... ";
+    std::stringstream snapshot;
+    walked.save(snapshot);
+    PriorityQueue<int> restored;
+    restored.load(snapshot);
+    assert(std::ranges::equal(restored, walked));  // Same heap layout, nothing re-sorted
+    restored.push(1000, 9);  // New pushes queue behind restored ties
+    PriorityQueue<int> expected_order(walked);
+    expected_order.push(1000, 9);
+    while (!expected_order.is_empty()) {
+        [[maybe_unused]] const int got = restored.pop();
+        [[maybe_unused]] const int want = expected_order.pop();
+        assert(got == want);
+    }
+
+    // Another arity gets heapified, the index is rebuilt in push order
+    IndexedPriorityQueue<std::string> names;
+    for (int i = 0; i < 200; ++i) names.push("n" + std::to_string(i), i % 7);
+    const auto path = std::filesystem::temp_directory_path() / "lab3_pq_snapshot.bin";
+    names.save(path);
+    IndexedPriorityQueue<std::string, 4> names_restored;
+    names_restored.load(path);
+    std::filesystem::remove(path);
+    assert(names_restored.get_size() == 200);
+    assert(names_restored.find_by_priority(3) == "n3");
+    assert(names_restored.find_by_value("n13") == 6);
+    while (!names.is_empty()) {
+        [[maybe_unused]] const std::string got = names_restored.pop();
+        [[maybe_unused]] const std::string want = names.pop();
+        assert(got == want);
+    }
+
+    std::stringstream truncated(snapshot.str().substr(0, snapshot.str().size() - 1));
+    try {
+        restored.load(truncated);
+        assert(false);
+    } catch (const std::runtime_error&) {}
+
+    // A forged count fails as a truncated snapshot instead of being allocated
+    std::stringstream empty_snapshot;
+    PriorityQueue<int>().save(empty_snapshot);
+    std::string forged = empty_snapshot.str();
+    forged.replace(forged.size() - 16, 8, 8, '\xff');  // The count, followed by next_seq
+    std::stringstream forged_snapshot(forged);
+    restored.push(7, 1);
+    try {
+        restored.load(forged_snapshot);
+        assert(false);
+    } catch (const std::runtime_error&) {}
+    assert(restored.get_size() == 1);
+    std::cout << "PASSED" << std::endl;
+
+    // Test 19: Statistics policy
+    std::cout << "Test 19: Statistics... ";
+    static_assert(!CountsStats<PriorityQueue<int>>);
+    PriorityQueue<int, 2, HeapAllocator, NoIndex, CountingStats> counted;
+    for (int i = 0; i < 100; ++i) counted.push(i, i); // every push sifts to the root
+    ContainerStats st = counted.stats();
+    assert(st.allocations == 8); // heap and slots at 16, 32, 64, 128
+    assert(st.frees == 6);
+    assert(st.high_water_size == 100);
+    assert(st.traversals == 100);
+    assert(st.longest_traversal == 6); // floor(log2(99))
+    assert(st.comparisons == st.traversal_steps); // no sift stopped early
+    counted.reset_stats();
+    assert(counted.find_by_value(-5) == -1);
+    assert(counted.contains_by_priority(99));
+    st = counted.stats();
+    assert(st.comparisons == 101);
+    assert(st.traversals == 2 && st.traversal_steps == 101 && st.longest_traversal == 100);
+    assert(counted.pop() == 99);
+    assert(counted.stats().comparisons > 101);
+    assert(counted.stats().high_water_size == 100);
+    std::cout << "PASSED" << std::endl;
+
     std::cout << "\n=== All Priority Queue tests PASSED! ===" << std::endl;
 }
\ No newline at end of file
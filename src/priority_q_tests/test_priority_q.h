@@ -7,5 +7,8 @@
 
 void run_tests_priority_q();
 void run_demo_priority_q();
+void run_tests_multi_queue();
+void run_tests_pairing_priority_q();
+void run_tests_external_priority_q();
 
 #endif //TEST_PRIORITY_Q_H
@@ -0,0 +1,295 @@
+#ifndef MMAP_QUEUE_H
+#define MMAP_QUEUE_H
+
+#ifndef _WIN32
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+ * msync policies for MmapQueue.
+ * batch = 0: never msync on our own, the kernel writes pages back
+ * when it likes. Either way a process crash loses nothing, since the
+ * pages live in the page cache; msync only matters for OS crashes.
+ * batch = n: msync after every n pushes/pops
+ */
+struct MsyncNever {
+    static constexpr size_t batch = 0;
+};
+
+struct MsyncAlways {
+    static constexpr size_t batch = 1;
+};
+
+template<size_t N>
+struct MsyncBatch {
+    static_assert(N > 0, "Use MsyncNever for no syncing");
+    static constexpr size_t batch = N;
+};
+
+/*
+ * Persistent FIFO of trivially copyable records in an mmap'd file.
+ * The file is a one-page header (head/tail counters, capacity)
+ * followed by a power-of-two ring of records. head and tail only
+ * ever grow, a record lives at counter & (capacity - 1).
+ * Opening an existing file maps it and reads the header, O(1)
+ * whatever the backlog. The ring doubles like Queue<E>; old slots are
+ * copied, not moved, and capacity is published last, so a crash
+ * mid-growth still leaves a valid file.
+ * Counters are published with release stores after the records they
+ * cover, and the magic is written last when a file is created: a file
+ * whose header is still all zeros is taken as new.
+ * A sync writes dirty records first, then the header that publishes them.
+ * One process at a time: the file is flock'ed while open
+ */
+
+template<typename E, typename Sync = MsyncNever>
+class MmapQueue {
+    static_assert(std::is_trivially_copyable_v<E>, "Records are stored as raw bytes");
+
+    private:
+    struct Header {
+        char magic[4];
+        uint32_t version;
+        uint32_t element_size;
+        uint32_t reserved;
+        uint64_t capacity;
+        uint64_t head;
+        uint64_t tail;
+    };
+
+    static constexpr char magic[4] = {'L', 'Q', 'M', 'Q'};
+    static constexpr uint32_t version = 1;
+    static constexpr size_t header_bytes = 4096;
+    static_assert(alignof(E) <= header_bytes);
+    static_assert(alignof(uint64_t) >= std::atomic_ref<uint64_t>::required_alignment);
+
+    int fd;
+    unsigned char* map;
+    size_t map_bytes;
+    Header* header;
+    E* records;
+    uint64_t synced_tail; // records below this are on disk
+    size_t pending_ops;
+
+    [[noreturn]] static void fail(const std::string& what) {
+        throw std::runtime_error(what + ": " + std::strerror(errno));
+    }
+
+    static size_t file_bytes(const uint64_t capacity) {
+        return header_bytes + static_cast<size_t>(capacity) * sizeof(E);
+    }
+
+    [[nodiscard]] size_t mask() const { return static_cast<size_t>(header->capacity) - 1; }
+
+    // Header counters live in shared memory, stores to them must not
+    // move ahead of the record and header writes they publish
+    static void publish(uint64_t& counter, const uint64_t value) {
+        std::atomic_ref<uint64_t>(counter).store(value, std::memory_order_release);
+    }
+
+    void map_file(const size_t bytes) {
+        void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) fail("Cannot map queue file");
+        map = static_cast<unsigned char*>(p);
+        map_bytes = bytes;
+        header = reinterpret_cast<Header*>(map);
+        records = reinterpret_cast<E*>(map + header_bytes);
+    }
+
+    void unmap() {
+        if (map != nullptr) ::munmap(map, map_bytes);
+        map = nullptr;
+        header = nullptr;
+        records = nullptr;
+    }
+
+    void close_file() {
+        unmap();
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+    }
+
+    // msync wants a page-aligned start
+    void msync_range(const size_t offset, const size_t bytes) const {
+        static const auto page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        const size_t start = offset / page * page;
+        if (::msync(map + start, offset + bytes - start, MS_SYNC) != 0) fail("Cannot sync queue file");
+    }
+
+    void msync_records(const uint64_t from, const uint64_t to) const {
+        const size_t capacity = static_cast<size_t>(header->capacity);
+        const size_t count = static_cast<size_t>(to - from);
+        const size_t first = static_cast<size_t>(from) & mask();
+        if (count >= capacity) {
+            msync_range(header_bytes, capacity * sizeof(E));
+        } else if (first + count <= capacity) {
+            msync_range(header_bytes + first * sizeof(E), count * sizeof(E));
+        } else {
+            msync_range(header_bytes + first * sizeof(E), (capacity - first) * sizeof(E));
+            msync_range(header_bytes, (first + count - capacity) * sizeof(E));
+        }
+    }
+
+    void after_op() {
+        if constexpr (Sync::batch > 0) {
+            if (++pending_ops >= Sync::batch) sync();
+        }
+    }
+
+    // The magic goes in last, a crash before it leaves a file open() recreates
+    void create(const uint64_t capacity) {
+        if (::ftruncate(fd, static_cast<off_t>(file_bytes(capacity))) != 0) fail("Cannot size queue file");
+        map_file(file_bytes(capacity));
+        header->version = version;
+        header->element_size = sizeof(E);
+        header->reserved = 0;
+        header->capacity = capacity;
+        header->head = 0;
+        header->tail = 0;
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(header->magic, magic, sizeof(magic));
+        msync_range(0, header_bytes);
+    }
+
+    // False if the header was never written (a crash inside create)
+    bool open_existing(const size_t size_on_disk) {
+        if (size_on_disk < header_bytes) throw std::runtime_error("Queue file is truncated");
+        map_file(size_on_disk);
+        const Header& h = *header;
+        static constexpr char unwritten[sizeof(magic)] = {};
+        if (std::memcmp(h.magic, unwritten, sizeof(magic)) == 0) {
+            unmap();
+            return false;
+        }
+        if (std::memcmp(h.magic, magic, sizeof(magic)) != 0) throw std::runtime_error("Not a queue file");
+        if (h.version != version) throw std::runtime_error("Unsupported queue file version");
+        if (h.element_size != sizeof(E)) throw std::runtime_error("Queue file holds another record type");
+        if (h.capacity == 0 || (h.capacity & (h.capacity - 1)) != 0 || file_bytes(h.capacity) > size_on_disk ||
+            h.tail < h.head || h.tail - h.head > h.capacity) {
+            throw std::runtime_error("Queue file header is corrupt");
+        }
+        return true;
+    }
+
+    void grow(const uint64_t min_capacity) {
+        const uint64_t old_capacity = header->capacity;
+        uint64_t new_capacity = old_capacity;
+        while (new_capacity < min_capacity) new_capacity *= 2;
+        if (::ftruncate(fd, static_cast<off_t>(file_bytes(new_capacity))) != 0) fail("Cannot grow queue file");
+        unmap();
+        map_file(file_bytes(new_capacity));
+
+        // Records whose index changes under the wider mask go to the new upper half
+        const uint64_t new_mask = new_capacity - 1;
+        for (uint64_t k = header->head; k < header->tail; ++k) {
+            const size_t from = static_cast<size_t>(k & (old_capacity - 1));
+            const size_t to = static_cast<size_t>(k & new_mask);
+            if (from != to) std::memcpy(static_cast<void*>(records + to), records + from, sizeof(E));
+        }
+        if constexpr (Sync::batch > 0) msync_range(header_bytes, static_cast<size_t>(new_capacity) * sizeof(E));
+        publish(header->capacity, new_capacity);
+        if constexpr (Sync::batch > 0) {
+            msync_range(0, header_bytes);
+            synced_tail = header->tail;
+        }
+    }
+
+    public:
+    // Open path, or create it with room for initial_capacity records
+    explicit MmapQueue(const std::filesystem::path& path, const size_t initial_capacity = 1024)
+        : fd(-1), map(nullptr), map_bytes(0), header(nullptr), records(nullptr), synced_tail(0), pending_ops(0) {
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0) fail("Cannot open queue file " + path.string());
+        try {
+            if (::flock(fd, LOCK_EX | LOCK_NB) != 0) fail("Queue file is in use " + path.string());
+            struct stat st{};
+            if (::fstat(fd, &st) != 0) fail("Cannot stat queue file");
+            if (st.st_size == 0 || !open_existing(static_cast<size_t>(st.st_size))) {
+                uint64_t capacity = 16;
+                while (capacity < initial_capacity) capacity *= 2;
+                create(capacity);
+            }
+            synced_tail = header->tail;
+        } catch (...) {
+            close_file();
+            throw;
+        }
+    }
+
+    // With a syncing policy the tail end of the last batch is synced too,
+    // errors are dropped here
+    ~MmapQueue() {
+        if constexpr (Sync::batch > 0) {
+            try {
+                sync();
+            } catch (...) {}
+        }
+        close_file();
+    }
+
+    MmapQueue(const MmapQueue&) = delete;
+    MmapQueue& operator=(const MmapQueue&) = delete;
+    MmapQueue(MmapQueue&&) = delete;
+    MmapQueue& operator=(MmapQueue&&) = delete;
+
+    // == Basic operations ==
+    [[nodiscard]] bool is_empty() const { return header->tail == header->head; }
+
+    [[nodiscard]] size_t get_size() const { return static_cast<size_t>(header->tail - header->head); }
+
+    [[nodiscard]] size_t get_capacity() const { return static_cast<size_t>(header->capacity); }
+
+    void reserve(const size_t n) {
+        if (n > header->capacity) grow(n);
+    }
+
+    [[nodiscard]] E peek_head() const {
+        if (is_empty()) throw std::out_of_range("Queue is empty");
+        return records[static_cast<size_t>(header->head) & mask()];
+    }
+
+    // The record is written before tail moves past it
+    void push(const E& e) {
+        if (get_size() == header->capacity) grow(header->capacity + 1);
+        const uint64_t tail = header->tail;
+        std::memcpy(static_cast<void*>(records + (static_cast<size_t>(tail) & mask())), &e, sizeof(E));
+        publish(header->tail, tail + 1);
+        after_op();
+    }
+
+    // The record is read before head frees its slot
+    E pop() {
+        if (is_empty()) throw std::out_of_range("Queue is empty");
+        const uint64_t head = header->head;
+        const E res = records[static_cast<size_t>(head) & mask()];
+        publish(header->head, head + 1);
+        after_op();
+        return res;
+    }
+
+    // Write dirty records, then the header, to disk
+    void sync() {
+        if (header == nullptr) return;
+        if (synced_tail < header->tail) msync_records(synced_tail, header->tail);
+        msync_range(0, header_bytes);
+        synced_tail = header->tail;
+        pending_ops = 0;
+    }
+};
+
+#endif //_WIN32
+
+#endif //MMAP_QUEUE_H
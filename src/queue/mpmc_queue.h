@@ -0,0 +1,140 @@
+#ifndef MPMC_QUEUE_H
+#define MPMC_QUEUE_H
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <thread>
+
+/*
+ * Bounded lock-free multi-producer/multi-consumer queue.
+ * Every slot carries a sequence number that tells whose turn it is:
+ *     seq == pos      - free, a producer at pos may fill it
+ *     seq == pos + 1  - full, a consumer at pos may take it
+ * Producers and consumers only race on their own counter,
+ * and the two counters live on separate cache lines
+ */
+
+template<typename E>
+class MpmcQueue {
+    private:
+    static constexpr size_t cache_line = 64;
+
+    struct Cell {
+        std::atomic<size_t> seq;
+        alignas(E) unsigned char storage[sizeof(E)];
+
+        E* item() { return reinterpret_cast<E*>(storage); }
+    };
+
+    alignas(cache_line) Cell* cells;
+    size_t mask;
+    alignas(cache_line) std::atomic<size_t> enqueue_pos;
+    alignas(cache_line) std::atomic<size_t> dequeue_pos;
+
+    static size_t round_up(const size_t n) {
+        size_t capacity = 2;
+        while (capacity < n) capacity *= 2;
+        return capacity;
+    }
+
+    template<typename T>
+    bool try_emplace(T&& e) {
+        size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[pos & mask];
+            const size_t seq = cell.seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<ptrdiff_t>(seq) - static_cast<ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    ::new (cell.item()) E(static_cast<T&&>(e));
+                    cell.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // full
+            } else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    public:
+    // Capacity is rounded up to a power of two
+    explicit MpmcQueue(const size_t capacity) : mask(round_up(capacity) - 1), enqueue_pos(0), dequeue_pos(0) {
+        cells = static_cast<Cell*>(::operator new((mask + 1) * sizeof(Cell), std::align_val_t(alignof(Cell))));
+        for (size_t i = 0; i <= mask; ++i) {
+            ::new (&cells[i].seq) std::atomic<size_t>(i);
+        }
+    }
+
+    // No other thread may touch the queue any more
+    ~MpmcQueue() {
+        const size_t tail = enqueue_pos.load(std::memory_order_acquire);
+        for (size_t pos = dequeue_pos.load(std::memory_order_acquire); pos != tail; ++pos) {
+            cells[pos & mask].item()->~E();
+        }
+        ::operator delete(cells, (mask + 1) * sizeof(Cell), std::align_val_t(alignof(Cell)));
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+    MpmcQueue(MpmcQueue&&) = delete;
+    MpmcQueue& operator=(MpmcQueue&&) = delete;
+
+    // == Basic operations ==
+    // Only a snapshot: other threads may change it right after the call
+    [[nodiscard]] size_t get_size() const {
+        const size_t tail = enqueue_pos.load(std::memory_order_acquire);
+        const size_t head = dequeue_pos.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+    [[nodiscard]] bool is_empty() const { return get_size() == 0; }
+
+    [[nodiscard]] size_t get_capacity() const { return mask + 1; }
+
+    // Never blocks, false if the queue is full
+    bool try_push(const E& e) { return try_emplace(e); }
+    bool try_push(E&& e) { return try_emplace(static_cast<E&&>(e)); }
+
+    // Never blocks, false if the queue is empty
+    bool try_pop(E& out) {
+        size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[pos & mask];
+            const size_t seq = cell.seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<ptrdiff_t>(seq) - static_cast<ptrdiff_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    E* item = cell.item();
+                    out = static_cast<E&&>(*item);
+                    item->~E();
+                    cell.seq.store(pos + mask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // empty
+            } else {
+                pos = dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Spin (yielding) until there is room
+    void push(const E& e) {
+        while (!try_emplace(e)) std::this_thread::yield();
+    }
+
+    void push(E&& e) {
+        while (!try_emplace(static_cast<E&&>(e))) std::this_thread::yield();
+    }
+
+    // Spin (yielding) until an element arrives, E must be default constructible
+    E pop() {
+        E res;
+        while (!try_pop(res)) std::this_thread::yield();
+        return res;
+    }
+};
+
+#endif //MPMC_QUEUE_H
@@ -4,109 +4,364 @@
 
 #ifndef QUEUE_H
 #define QUEUE_H
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <iterator>
+#include <new>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
 
-template<typename E>
+#include "allocator/allocator.h"
+#include "io/dump_writer.h"
+#include "io/snapshot.h"
+#include "stats/stats.h"
+
+/*
+ * Growable circular buffer.
+ * Capacity is always a power of two, so wrapping
+ * an index is a single mask instead of a division.
+ * The buffer comes from the Alloc policy (see allocator/allocator.h),
+ * the Stats policy may count its use (see stats/stats.h)
+ */
+
+template<typename E, typename Alloc = HeapAllocator, typename Stats = NoStats>
 class Queue {
     private:
-    struct Node {
-        E data;
-        Node* next;
+    static constexpr size_t load_chunk = 1024; // first read of load, in elements
 
-        explicit Node(const E& d) : data(d), next(nullptr) {}
-        explicit Node(E&& d) : data(static_cast<E&&>(d)), next(nullptr) {}
-        ~Node() = default;
-    };
     size_t size;
-    Node* head;
+    size_t capacity;
+    size_t head;
+    E* buffer;
+    [[no_unique_address]] Alloc allocator;
+    [[no_unique_address]] mutable Stats counters;
+
+    void free_buffer() {
+        if (buffer == nullptr) return;
+        allocator.deallocate(buffer, capacity * sizeof(E), alignof(E));
+        counters.on_free();
+    }
+
+    [[nodiscard]] size_t slot(const size_t i) const { return (head + i) & (capacity - 1); }
+
+    void grow(const size_t min_capacity) {
+        size_t new_capacity = capacity ? capacity : 16;
+        while (new_capacity < min_capacity) new_capacity *= 2;
+
+        auto fresh = static_cast<E*>(allocator.allocate(new_capacity * sizeof(E), alignof(E)));
+        counters.on_alloc();
+        counters.on_memory((capacity + new_capacity) * sizeof(E));
+        for (size_t i = 0; i < size; ++i) {
+            E& old = buffer[slot(i)];
+            ::new (fresh + i) E(static_cast<E&&>(old));
+            old.~E();
+        }
+        free_buffer();
+        buffer = fresh;
+        capacity = new_capacity;
+        head = 0;
+    }
+
+    // Destroy everything from position `from` up to the tail,
+    // O(1) when E has nothing to destroy
+    void destroy_tail(const size_t from) {
+        if constexpr (!std::is_trivially_destructible_v<E>) {
+            for (size_t i = from; i < size; ++i) buffer[slot(i)].~E();
+        }
+        size = from;
+    }
+
+    template<typename T>
+    void emplace_back(T&& e) {
+        if (size == capacity) grow(size + 1);
+        ::new (buffer + slot(size)) E(static_cast<T&&>(e));
+        ++size;
+        counters.on_size(size);
+    }
+
+    // One buffer sized for other, elements copied front to back.
+    // Trivially copyable elements are copied as at most two blocks
+    void copy_from(const Queue& other) {
+        if (other.is_empty()) return;
+        grow(other.size);
+        if constexpr (std::is_trivially_copyable_v<E>) {
+            const size_t first = other.capacity - other.head < other.size ? other.capacity - other.head : other.size;
+            std::memcpy(static_cast<void*>(buffer), other.buffer + other.head, first * sizeof(E));
+            std::memcpy(static_cast<void*>(buffer + first), other.buffer, (other.size - first) * sizeof(E));
+            size = other.size;
+            counters.on_size(size);
+        } else {
+            for (size_t i = 0; i < other.size; ++i) emplace_back(other.buffer[other.slot(i)]);
+        }
+    }
 
     public:
+    // Walks from head to tail, the order pop would return elements in
+    class const_iterator {
+        private:
+        const E* buffer = nullptr;
+        size_t mask = 0;
+        size_t pos = 0; // head + index, wrapped on access
+
+        public:
+        using iterator_concept = std::forward_iterator_tag;
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = E;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const E*;
+        using reference = const E&;
+
+        const_iterator() = default;
+        const_iterator(const E* b, const size_t m, const size_t p) : buffer(b), mask(m), pos(p) {}
+
+        reference operator*() const { return buffer[pos & mask]; }
+        pointer operator->() const { return buffer + (pos & mask); }
+
+        const_iterator& operator++() {
+            ++pos;
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator temp = *this;
+            ++pos;
+            return temp;
+        }
+
+        friend bool operator==(const const_iterator&, const const_iterator&) = default;
+    };
+
+    using iterator = const_iterator;
+
     // Constructor
-    explicit Queue() : size(0), head(nullptr) {}
+    explicit Queue(const Alloc& alloc = Alloc())
+        : size(0), capacity(0), head(0), buffer(nullptr), allocator(alloc) {}
     // Destructor
     ~Queue() {
-        while (head != nullptr) {
-            const Node* temp = head;
-            head = head->next;
-            delete temp;
-        }
-        head = nullptr;
+        destroy_tail(0);
+        free_buffer();
+        buffer = nullptr;
+    }
+    // Deep copy, shares other's allocator
+    Queue(const Queue& other) : Queue(other.allocator) {
+        copy_from(other);
+    }
+    // Takes over other's buffer, other is left empty
+    Queue(Queue&& other) noexcept
+        : size(other.size), capacity(other.capacity), head(other.head), buffer(other.buffer),
+          allocator(other.allocator) {
+        other.size = 0;
+        other.capacity = 0;
+        other.head = 0;
+        other.buffer = nullptr;
+    }
+
+    Queue& operator=(const Queue& other) {
+        if (this != &other) Queue(other).swap(*this);
+        return *this;
+    }
+
+    Queue& operator=(Queue&& other) noexcept {
+        if (this != &other) Queue(static_cast<Queue&&>(other)).swap(*this);
+        return *this;
+    }
+
+    void swap(Queue& other) noexcept {
+        std::swap(size, other.size);
+        std::swap(capacity, other.capacity);
+        std::swap(head, other.head);
+        std::swap(buffer, other.buffer);
+        std::swap(allocator, other.allocator);
     }
-    // Prohibit assignment and movement
-    Queue& operator=(const Queue&) = delete;
-    Queue(const Queue&) = delete;
-    Queue& operator=(Queue&&) = delete;
-    Queue(Queue&&) = delete;
+
+    friend void swap(Queue& a, Queue& b) noexcept { a.swap(b); }
 
     // == Basic operations ==
     [[nodiscard]] bool is_empty() const { return size == 0; }
 
     [[nodiscard]] size_t get_size() const { return size; }
 
+    [[nodiscard]] size_t get_capacity() const { return capacity; }
+
+    // Preallocate storage so the next n - size pushes never reallocate
+    void reserve(const size_t n) {
+        if (n > capacity) grow(n);
+    }
+
     [[maybe_unused]] const E& peek_head() const {
         if (is_empty()) throw std::out_of_range("Queue is empty");
-        return head->data;
+        return buffer[head];
     }
 
     void push(E&& e) {
-        auto newNode = new Node(static_cast<E&&>(e));
-        if (is_empty()) head = newNode;
-        else {
-            auto curr = head;
-            while (curr->next != nullptr) curr = curr->next;
-            curr->next = newNode;
-        }
-        ++size;
+        emplace_back(static_cast<E&&>(e));
     }
 
     void push(const E& e) {
-        auto newNode = new Node(e);
-        if (is_empty()) head = newNode;
-        else {
-            auto curr = head;
-            while (curr->next != nullptr) curr = curr->next;
-            curr->next = newNode;
+        emplace_back(e);
+    }
+
+    // Append [first, last), storage grows at most once for forward iterators
+    // Use std::make_move_iterator to move elements in
+    template<typename It>
+    void push_range(It first, It last) {
+        if constexpr (std::forward_iterator<It>) {
+            reserve(size + static_cast<size_t>(std::distance(first, last)));
         }
-        ++size;
+        for (; first != last; ++first) emplace_back(*first);
     }
 
-    /*
-        * Theoretically we can store pointer to tail
-        * and check if element closer to head or to tail
-        * but its more dequeue style
-    */
     [[maybe_unused]] E pop() {
         if (is_empty()) throw std::out_of_range("Queue is empty");
-        auto temp = head;
-        E res = static_cast<E&&>(temp->data);
-        head = head->next;
-        delete temp;
+        E& front = buffer[head];
+        E res = static_cast<E&&>(front);
+        front.~E();
+        head = slot(1);
         --size;
         return res;
     }
 
-    void remove_from(E value) {
-        if (is_empty()) throw std::out_of_range("Queue is empty");
-        auto curr = head;
-        while (curr->next->data != value && curr != nullptr) {
-            curr = curr->next;
+    // Move up to n elements into out in FIFO order, returns how many were taken
+    template<typename Out>
+    size_t pop_n(Out out, const size_t n) {
+        const size_t count = n < size ? n : size;
+        for (size_t i = 0; i < count; ++i) {
+            E& front = buffer[head];
+            *out = static_cast<E&&>(front);
+            ++out;
+            front.~E();
+            head = slot(1);
         }
-        if (curr != nullptr) {
-            auto toDel = curr->next;
-            curr->next = nullptr;
-            while (toDel != nullptr) {
-                auto temp = toDel;
-                toDel = toDel->next;
-                delete temp;
+        size -= count;
+        return count;
+    }
+
+    // == Bulk edits ==
+    // Drop the first occurrence of value and everything after it,
+    // returns how many elements were dropped
+    size_t truncate_from(const E& value) {
+        for (size_t i = 0; i < size; ++i) {
+            if (buffer[slot(i)] == value) {
+                counters.on_compare(i + 1);
+                counters.on_traverse(i + 1);
+                return truncate_at(i);
             }
         }
+        counters.on_compare(size);
+        counters.on_traverse(size);
+        return 0;
+    }
+
+    // Keep only the first `index` elements, returns how many were dropped
+    size_t truncate_at(const size_t index) {
+        if (index >= size) return 0;
+        const size_t dropped = size - index;
+        destroy_tail(index);
+        return dropped;
+    }
+
+    // Move every element of other to the back of this queue, other ends up empty.
+    // Taking over other's buffer is O(1) when this queue is empty
+    // and both use the same allocator, otherwise one bulk move
+    void append(Queue&& other) {
+        if (this == &other || other.is_empty()) return;
+        if (is_empty() && allocator == other.allocator) {
+            free_buffer();
+            buffer = other.buffer;
+            capacity = other.capacity;
+            head = other.head;
+            size = other.size;
+            counters.on_size(size);
+            counters.on_memory(capacity * sizeof(E));
+            other.buffer = nullptr;
+            other.capacity = 0;
+            other.head = 0;
+            other.size = 0;
+            return;
+        }
+        reserve(size + other.size);
+        for (size_t i = 0; i < other.size; ++i) emplace_back(static_cast<E&&>(other.buffer[other.slot(i)]));
+        other.destroy_tail(0);
+        other.head = 0;
+    }
+
+    void splice(Queue& other) {
+        append(static_cast<Queue&&>(other));
+    }
+
+    // == Statistics (see stats/stats.h) ==
+    [[nodiscard]] ContainerStats stats() const requires Stats::enabled { return counters.snapshot(capacity * sizeof(E)); }
+
+    void reset_stats() requires Stats::enabled { counters.reset(size, capacity * sizeof(E)); }
+
+    // == Traversal ==
+    [[nodiscard]] const_iterator begin() const { return const_iterator(buffer, capacity - 1, head); }
+    [[nodiscard]] const_iterator end() const { return const_iterator(buffer, capacity - 1, head + size); }
+    [[nodiscard]] const_iterator cbegin() const { return begin(); }
+    [[nodiscard]] const_iterator cend() const { return end(); }
+
+    // == Output ==
+    // Up to limit elements from head to tail, a cut is marked with "..."
+    void dump(DumpWriter& out, const size_t limit = DumpWriter::no_limit) const {
+        const size_t shown = limit < size ? limit : size;
+        for (size_t i = 0; i < shown; ++i) out << buffer[slot(i)] << ' ';
+        if (shown < size) out << "... (" << size - shown << " more)";
+    }
+
+    void dump(std::ostream& os, const size_t limit = DumpWriter::no_limit) const {
+        DumpWriter out(os);
+        dump(out, limit);
+    }
+
+    void dump_to(const int fd, const size_t limit = DumpWriter::no_limit) const {
+        DumpWriter out(fd);
+        dump(out, limit);
+    }
+
+    // == Snapshots (see io/snapshot.h) ==
+    // Elements head to tail, at most two codec calls since the ring may wrap
+    void save(std::ostream& os) const {
+        Snapshot::Writer w(os);
+        Snapshot::write_header<E>(w, Snapshot::Kind::QUEUE, size);
+        const size_t first = capacity - head < size ? capacity - head : size;
+        SnapshotCodec<E>::write(w, buffer + head, first);
+        SnapshotCodec<E>::write(w, buffer, size - first);
+    }
+
+    // Replace the contents. The header count is not trusted for the
+    // allocation: elements are read in chunks that double with what has
+    // arrived, so a corrupt count fails as a truncated snapshot.
+    // The queue is left unchanged if the snapshot is bad
+    void load(std::istream& is) {
+        Snapshot::Reader r(is);
+        uint64_t left = Snapshot::read_header<E>(r, Snapshot::Kind::QUEUE);
+        Queue fresh(allocator);
+        while (left > 0) {
+            const size_t step = fresh.size > load_chunk ? fresh.size : load_chunk;
+            const size_t count = left < step ? static_cast<size_t>(left) : step;
+            fresh.reserve(fresh.size + count);
+            SnapshotCodec<E>::read(r, fresh.buffer + fresh.size, count);
+            fresh.size += count;
+            left -= count;
+        }
+        swap(fresh);
+    }
+
+    void save(const std::filesystem::path& path) const {
+        Snapshot::save_file(path, [this](std::ostream& os) { save(os); });
+    }
+
+    void load(const std::filesystem::path& path) {
+        Snapshot::load_file(path, [this](std::istream& is) { load(is); });
     }
 
     void peek_q() const {
         if (is_empty()) throw std::out_of_range("Queue is empty");
-        for (auto current = head; current != nullptr; current = current->next) {
-            std::cout << current->data << " ";
-        }
+        dump(std::cout);
     }
 };
 
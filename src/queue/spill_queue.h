@@ -0,0 +1,224 @@
+#ifndef SPILL_QUEUE_H
+#define SPILL_QUEUE_H
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include "io/snapshot.h"
+#include "queue.h"
+
+/*
+ * FIFO with a memory budget.
+ * Elements flow front <- [segments on disk] <- back.
+ * While the queue fits in the budget it is two Queue<E> in RAM and never
+ * touches the disk. Once it passes the budget, its newest elements are
+ * cut into segments of a quarter budget each, until at most half the
+ * budget stays resident, and written sequentially to files in the spill
+ * directory; from then on back is flushed every time it fills a segment.
+ * Every segment is full, a short one is never written.
+ * The oldest segment is read ahead on a background thread while the
+ * consumer drains front, so a pop rarely waits for the disk.
+ * RAM holds at most front + one prefetched segment + back <= budget elements.
+ * Segment files use the Queue snapshot format (see io/snapshot.h),
+ * so E needs a SnapshotCodec
+ */
+
+template<typename E>
+class SpillQueue {
+    private:
+    struct Segment {
+        std::filesystem::path path;
+        size_t count;
+    };
+
+    Queue<E> front;
+    Queue<E> back;
+    std::deque<Segment> segments; // on disk, oldest first
+    std::future<Queue<E>> prefetch;
+    Segment in_flight;            // the segment prefetch is reading
+    size_t budget;
+    size_t segment_size;
+    size_t spilled;               // elements in segments and in flight
+    std::filesystem::path directory;
+    std::string prefix;
+    unsigned long long next_segment;
+
+    // Resident elements left after the first spill: room for one prefetched
+    // segment and one filling back stays under the budget
+    [[nodiscard]] size_t resident_limit() const { return budget - 2 * segment_size; }
+
+    [[nodiscard]] bool spilling() const { return !segments.empty() || prefetch.valid(); }
+
+    std::filesystem::path segment_path() {
+        return directory / (prefix + std::to_string(next_segment++) + ".seg");
+    }
+
+    // Write [it, it + count) as one segment
+    void write_segment(typename Queue<E>::const_iterator& it, const size_t count) {
+        Segment segment{segment_path(), count};
+        try {
+            std::ofstream os(segment.path, std::ios::binary | std::ios::trunc);
+            if (!os) throw std::runtime_error("Cannot create spill segment: " + segment.path.string());
+            Snapshot::Writer w(os);
+            Snapshot::write_header<E>(w, Snapshot::Kind::QUEUE, count);
+            for (size_t i = 0; i < count; ++i, ++it) SnapshotCodec<E>::write(w, &*it, 1);
+            os.close();
+            if (!os) throw std::runtime_error("Spill segment write failed: " + segment.path.string());
+        } catch (...) {
+            std::error_code ignored;
+            std::filesystem::remove(segment.path, ignored);
+            throw;
+        }
+        segments.push_back(static_cast<Segment&&>(segment));
+        spilled += count;
+    }
+
+    // back holds exactly one segment, move it to disk
+    void spill_back() {
+        auto it = back.begin();
+        write_segment(it, segment_size);
+        Queue<E>().swap(back); // give the buffer back, not just the elements
+        start_prefetch();
+    }
+
+    // RAM passed the budget with nothing on disk, so any suffix of
+    // front + back may go there: the newest elements are written in whole
+    // segments until at most resident_limit() stay. A failed write
+    // deletes the segments written so far and keeps everything in RAM
+    void spill_resident() {
+        front.append(static_cast<Queue<E>&&>(back));
+        const size_t over = front.get_size() - resident_limit();
+        const size_t count = (over + segment_size - 1) / segment_size * segment_size;
+        const size_t keep = front.get_size() - count;
+        auto it = front.begin();
+        std::advance(it, static_cast<std::ptrdiff_t>(keep));
+        try {
+            for (size_t left = count; left > 0; left -= segment_size) write_segment(it, segment_size);
+        } catch (...) {
+            std::error_code ignored;
+            for (const Segment& segment : segments) std::filesystem::remove(segment.path, ignored);
+            segments.clear();
+            spilled = 0;
+            throw;
+        }
+        front.truncate_at(keep);
+        start_prefetch();
+    }
+
+    void start_prefetch() {
+        if (prefetch.valid() || segments.empty()) return;
+        in_flight = static_cast<Segment&&>(segments.front());
+        segments.pop_front();
+        prefetch = std::async(std::launch::async, [path = in_flight.path] {
+            Queue<E> q;
+            q.load(path);
+            return q;
+        });
+    }
+
+    // front is empty: take the next segment, or back once nothing is on disk
+    void refill() {
+        start_prefetch();
+        if (prefetch.valid()) {
+            std::error_code ignored;
+            try {
+                front = prefetch.get();
+            } catch (...) {
+                // The segment is lost: stop counting it and drop its file
+                spilled -= in_flight.count;
+                std::filesystem::remove(in_flight.path, ignored);
+                throw;
+            }
+            spilled -= in_flight.count;
+            std::filesystem::remove(in_flight.path, ignored);
+            start_prefetch();
+        } else {
+            front.append(static_cast<Queue<E>&&>(back));
+        }
+    }
+
+    void after_push() {
+        if (spilling()) {
+            if (back.get_size() == segment_size) spill_back();
+        } else if (front.get_size() + back.get_size() > budget) {
+            spill_resident();
+        }
+    }
+
+    public:
+    // budget: elements kept in RAM, at least 4.
+    // directory: where segments go, the system temp directory by default
+    explicit SpillQueue(const size_t memory_budget,
+                        std::filesystem::path spill_directory = std::filesystem::temp_directory_path())
+        : in_flight{}, budget(memory_budget < 4 ? 4 : memory_budget), segment_size(budget / 4), spilled(0),
+          directory(static_cast<std::filesystem::path&&>(spill_directory)), next_segment(0) {
+        std::random_device random;
+        prefix = "spill_" + std::to_string(random()) + "_" + std::to_string(reinterpret_cast<uintptr_t>(this)) + "_";
+    }
+
+    // Segments left behind are deleted
+    ~SpillQueue() {
+        std::error_code ignored;
+        if (prefetch.valid()) {
+            prefetch.wait();
+            std::filesystem::remove(in_flight.path, ignored);
+        }
+        for (const Segment& segment : segments) std::filesystem::remove(segment.path, ignored);
+    }
+
+    SpillQueue(const SpillQueue&) = delete;
+    SpillQueue& operator=(const SpillQueue&) = delete;
+    SpillQueue(SpillQueue&&) = delete;
+    SpillQueue& operator=(SpillQueue&&) = delete;
+
+    // == Basic operations ==
+    [[nodiscard]] bool is_empty() const { return get_size() == 0; }
+
+    [[nodiscard]] size_t get_size() const { return front.get_size() + spilled + back.get_size(); }
+
+    [[nodiscard]] size_t get_budget() const { return budget; }
+
+    // Elements held in RAM, a segment being prefetched included
+    [[nodiscard]] size_t get_in_memory() const {
+        return front.get_size() + back.get_size() + (prefetch.valid() ? in_flight.count : 0);
+    }
+
+    // Elements only on disk
+    [[nodiscard]] size_t get_on_disk() const {
+        return spilled - (prefetch.valid() ? in_flight.count : 0);
+    }
+
+    [[nodiscard]] size_t get_segment_count() const { return segments.size() + (prefetch.valid() ? 1 : 0); }
+
+    void push(E&& e) {
+        back.push(static_cast<E&&>(e));
+        after_push();
+    }
+
+    void push(const E& e) {
+        back.push(e);
+        after_push();
+    }
+
+    // May wait for the next segment to be read
+    [[maybe_unused]] const E& peek_head() {
+        if (front.is_empty()) refill();
+        return front.peek_head();
+    }
+
+    [[maybe_unused]] E pop() {
+        if (is_empty()) throw std::out_of_range("Queue is empty");
+        if (front.is_empty()) refill();
+        return front.pop();
+    }
+};
+
+#endif //SPILL_QUEUE_H
@@ -0,0 +1,158 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <thread>
+
+/*
+ * Wait-free bounded single-producer/single-consumer ring.
+ * Exactly one thread may push and exactly one thread may pop.
+ * Each side keeps a private copy of the other side's index and only
+ * reloads the shared atomic when the copy says full/empty, so in the
+ * steady state a handoff touches no cache line owned by the other core.
+ * Batch calls publish their whole batch with a single release store
+ */
+
+template<typename E>
+class SpscQueue {
+    private:
+    static constexpr size_t cache_line = 64;
+
+    // Producer side
+    alignas(cache_line) std::atomic<size_t> tail;
+    size_t cached_head;
+    // Consumer side
+    alignas(cache_line) std::atomic<size_t> head;
+    size_t cached_tail;
+    // Shared, read-only after construction
+    alignas(cache_line) E* buffer;
+    size_t mask;
+
+    static size_t round_up(const size_t n) {
+        size_t capacity = 2;
+        while (capacity < n) capacity *= 2;
+        return capacity;
+    }
+
+    // Free slots as seen by the producer, refreshes the cached head if needed
+    size_t free_slots(const size_t t, const size_t wanted) {
+        size_t available = mask + 1 - (t - cached_head);
+        if (available < wanted) {
+            cached_head = head.load(std::memory_order_acquire);
+            available = mask + 1 - (t - cached_head);
+        }
+        return available;
+    }
+
+    // Filled slots as seen by the consumer, refreshes the cached tail if needed
+    size_t filled_slots(const size_t h, const size_t wanted) {
+        size_t available = cached_tail - h;
+        if (available < wanted) {
+            cached_tail = tail.load(std::memory_order_acquire);
+            available = cached_tail - h;
+        }
+        return available;
+    }
+
+    template<typename T>
+    bool try_emplace(T&& e) {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        if (free_slots(t, 1) == 0) return false;
+        ::new (buffer + (t & mask)) E(static_cast<T&&>(e));
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    public:
+    // Capacity is rounded up to a power of two
+    explicit SpscQueue(const size_t capacity)
+        : tail(0), cached_head(0), head(0), cached_tail(0), mask(round_up(capacity) - 1) {
+        buffer = static_cast<E*>(::operator new((mask + 1) * sizeof(E), std::align_val_t(alignof(E))));
+    }
+
+    // Neither thread may touch the queue any more
+    ~SpscQueue() {
+        const size_t t = tail.load(std::memory_order_acquire);
+        for (size_t h = head.load(std::memory_order_acquire); h != t; ++h) buffer[h & mask].~E();
+        ::operator delete(buffer, (mask + 1) * sizeof(E), std::align_val_t(alignof(E)));
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+    SpscQueue(SpscQueue&&) = delete;
+    SpscQueue& operator=(SpscQueue&&) = delete;
+
+    // == Basic operations ==
+    // Only a snapshot when called concurrently
+    [[nodiscard]] size_t get_size() const {
+        const size_t h = head.load(std::memory_order_acquire);
+        const size_t t = tail.load(std::memory_order_acquire);
+        return t - h;
+    }
+
+    [[nodiscard]] bool is_empty() const { return get_size() == 0; }
+
+    [[nodiscard]] size_t get_capacity() const { return mask + 1; }
+
+    // === Producer ===
+    bool try_push(const E& e) { return try_emplace(e); }
+    bool try_push(E&& e) { return try_emplace(static_cast<E&&>(e)); }
+
+    void push(const E& e) {
+        while (!try_emplace(e)) std::this_thread::yield();
+    }
+
+    void push(E&& e) {
+        while (!try_emplace(static_cast<E&&>(e))) std::this_thread::yield();
+    }
+
+    // Copy up to n elements from first, returns how many were published
+    template<typename It>
+    size_t try_push_n(It first, const size_t n) {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        const size_t available = free_slots(t, n);
+        const size_t count = n < available ? n : available;
+        for (size_t i = 0; i < count; ++i, ++first) {
+            ::new (buffer + ((t + i) & mask)) E(*first);
+        }
+        tail.store(t + count, std::memory_order_release);
+        return count;
+    }
+
+    // === Consumer ===
+    bool try_pop(E& out) {
+        const size_t h = head.load(std::memory_order_relaxed);
+        if (filled_slots(h, 1) == 0) return false;
+        E& item = buffer[h & mask];
+        out = static_cast<E&&>(item);
+        item.~E();
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Spin (yielding) until an element arrives, E must be default constructible
+    E pop() {
+        E res;
+        while (!try_pop(res)) std::this_thread::yield();
+        return res;
+    }
+
+    // Move up to n elements into out, returns how many were consumed
+    template<typename Out>
+    size_t try_pop_n(Out out, const size_t n) {
+        const size_t h = head.load(std::memory_order_relaxed);
+        const size_t available = filled_slots(h, n);
+        const size_t count = n < available ? n : available;
+        for (size_t i = 0; i < count; ++i) {
+            E& item = buffer[(h + i) & mask];
+            *out = static_cast<E&&>(item);
+            ++out;
+            item.~E();
+        }
+        head.store(h + count, std::memory_order_release);
+        return count;
+    }
+};
+
+#endif //SPSC_QUEUE_H
@@ -0,0 +1,104 @@
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include "queue/mmap_queue.h"
+#include "test_queue.h"
+
+#ifndef _WIN32
+namespace {
+    struct Record {
+        int id;
+        double value;
+    };
+}
+
+void run_tests_mmap_queue() {
+    std::cout << "=== Running Mmap Queue Tests ===" << std::endl;
+    const auto path = std::filesystem::temp_directory_path() / "lab3_mmap_queue.bin";
+    std::filesystem::remove(path);
+
+    // Test 1: FIFO order and growth past the initial capacity
+    std::cout << "Test 1: FIFO and growth... ";
+    {
+        MmapQueue<Record> q(path, 16);
+        assert(q.is_empty());
+        assert(q.get_capacity() == 16);
+        for (int i = 0; i < 10; ++i) q.push(Record{i, i * 0.5});
+        for (int i = 0; i < 6; ++i) assert(q.pop().id == i);
+        // Wrapped contents must survive a resize
+        for (int i = 10; i < 100; ++i) q.push(Record{i, i * 0.5});
+        assert(q.get_capacity() == 128);
+        assert(q.get_size() == 94);
+        assert(q.peek_head().id == 6);
+        for (int i = 6; i < 50; ++i) {
+            const Record r = q.pop();
+            assert(r.id == i && r.value == i * 0.5);
+        }
+    }
+    std::cout << "PASSED" << std::endl;
+
+    // Test 2: Reopen picks up where the last process stopped
+    std::cout << "Test 2: Reopen... ";
+    {
+        MmapQueue<Record, MsyncBatch<8>> q(path);
+        assert(q.get_size() == 50);
+        assert(q.get_capacity() == 128);
+        assert(q.peek_head().id == 50);
+        for (int i = 100; i < 110; ++i) q.push(Record{i, 0});
+    }
+    {
+        MmapQueue<Record, MsyncAlways> q(path);
+        assert(q.get_size() == 60);
+        for (int i = 50; i < 110; ++i) assert(q.pop().id == i);
+        assert(q.is_empty());
+        try {
+            q.pop();
+            assert(false);
+        } catch (const std::out_of_range&) {}
+
+        // Only one owner at a time
+        try {
+            MmapQueue<Record> second(path);
+            assert(false);
+        } catch (const std::runtime_error&) {}
+    }
+    std::cout << "PASSED" << std::endl;
+
+    // Test 3: Files of another record type are rejected
+    std::cout << "Test 3: Record type check... ";
+    try {
+        MmapQueue<char> wrong(path);
+        assert(false);
+    } catch (const std::runtime_error&) {}
+    std::filesystem::remove(path);
+    std::cout << "PASSED" << std::endl;
+
+    // Test 4: A file sized but never given a header (crash inside create) is new
+    std::cout << "Test 4: Unwritten header... ";
+    {
+        std::ofstream zeros(path, std::ios::binary);
+        zeros << std::string(8192, '\0');
+    }
+    {
+        MmapQueue<Record> q(path, 32);
+        assert(q.is_empty());
+        assert(q.get_capacity() == 32);
+        q.push(Record{1, 1.0});
+    }
+    {
+        MmapQueue<Record> q(path);
+        assert(q.get_size() == 1);
+    }
+    std::filesystem::remove(path);
+    std::cout << "PASSED" << std::endl;
+
+    std::cout << "\n=== All Mmap Queue tests PASSED! ===" << std::endl;
+}
+#else
+void run_tests_mmap_queue() {
+    std::cout << "=== Mmap Queue Tests skipped, POSIX only ===" << std::endl;
+}
+#endif
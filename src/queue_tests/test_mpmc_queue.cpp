@@ -0,0 +1,94 @@
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "queue/mpmc_queue.h"
+#include "test_queue.h"
+
+void run_tests_mpmc_queue() {
+    std::cout << "=== Running MPMC Queue Tests ===" << std::endl;
+
+    // Test 1: Single-threaded FIFO and bounds
+    std::cout << "Test 1: FIFO and bounds... ";
+    MpmcQueue<std::string> q(3);
+    assert(q.get_capacity() == 4);
+    assert(q.is_empty());
+
+    for (int i = 0; i < 4; ++i) assert(q.try_push(std::to_string(i)));
+    assert(!q.try_push("overflow"));  // Full queue never blocks
+    assert(q.get_size() == 4);
+
+    std::string out;
+    for (int i = 0; i < 4; ++i) {
+        assert(q.try_pop(out));
+        assert(out == std::to_string(i));
+    }
+    assert(!q.try_pop(out));  // Empty queue never blocks
+    assert(q.is_empty());
+    std::cout << "PASSED" << std::endl;
+
+    // Test 2: Stress from N producers and N consumers
+    std::cout << "Test 2: Multi-threaded stress... ";
+    const unsigned hw = std::thread::hardware_concurrency();
+    const int threads = hw < 2 ? 2 : (hw > 8 ? 8 : static_cast<int>(hw));
+    constexpr int PER_PRODUCER = 100000;
+    const int total = threads * PER_PRODUCER;
+
+    MpmcQueue<int> shared(1024);
+    std::atomic<int> consumed{0};
+    std::vector<std::vector<int>> received(threads);
+    std::vector<std::thread> workers;
+
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&shared, t] {
+            for (int i = 0; i < PER_PRODUCER; ++i) shared.push(t * PER_PRODUCER + i);
+        });
+        workers.emplace_back([&shared, &consumed, &received, t, total] {
+            int value;
+            while (consumed.load(std::memory_order_relaxed) < total) {
+                if (shared.try_pop(value)) {
+                    received[t].push_back(value);
+                    consumed.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    // Every value exactly once, and each producer's values in order per consumer
+    std::vector<int> seen(total, 0);
+    for (const auto& values : received) {
+        std::vector<int> last(threads, -1);
+        for (const int v : values) {
+            ++seen[v];
+            assert(v > last[v / PER_PRODUCER]);
+            last[v / PER_PRODUCER] = v;
+        }
+    }
+    for (const int count : seen) assert(count == 1);
+    assert(shared.is_empty());
+    std::cout << "PASSED" << std::endl;
+
+    // Test 3: Elements aligned past what plain operator new guarantees
+    std::cout << "Test 3: Over-aligned elements... ";
+    struct alignas(128) Wide {
+        int value;
+    };
+    MpmcQueue<Wide> wide(4);
+    for (int i = 0; i < 4; ++i) {
+        [[maybe_unused]] const bool pushed = wide.try_push(Wide{i});
+        assert(pushed);
+    }
+    Wide got{};
+    for (int i = 0; i < 4; ++i) {
+        [[maybe_unused]] const bool popped = wide.try_pop(got);
+        assert(popped && got.value == i);
+    }
+    std::cout << "PASSED" << std::endl;
+
+    std::cout << "\n=== All MPMC Queue tests PASSED! ===" << std::endl;
+}
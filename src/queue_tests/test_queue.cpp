@@ -2,10 +2,26 @@
 // Created by IWOFLEUR on 20.09.2025.
 //
 #include "test_queue.h"
+#include <algorithm>
 #include <cassert>
+#include <filesystem>
 #include <iostream>
+#include <iterator>
+#include <ranges>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "io/dump_writer.h"
 #include "queue/queue.h"
+#include "stats/stats.h"
+#include "stack/stack.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
 
 void run_demo_queue() {
     std::cout << "\n=== Queue Demo ====" << std::endl;
@@ -21,9 +37,14 @@ void run_demo_queue() {
     std::cout << "Queue size: " << q.get_size() << std::endl;
     std::cout << "head element: " << q.peek_head() << std::endl;
 
+    std::cout << "Contents: ";
+    q.dump(std::cout);
+    std::cout << std::endl;
+
     std::cout << "\nExtracting all elements (FIFO order):" << std::endl;
+    DumpWriter out(std::cout);
     while (!q.is_empty()) {
-        std::cout << "Popped: " << q.pop() << std::endl;
+        out << "Popped: " << q.pop() << '\n';
     }
 }
 
@@ -128,5 +149,224 @@ void run_tests_queue() {
     assert(charQueue.pop() == 'B');
     std::cout << "PASSED" << std::endl;
 
+    // Test 8: Wrap-around and growth of the ring buffer
+    std::cout << "Test 8: Wrap-around and growth... ";
+    Queue<int> q5;
+    q5.reserve(16);
+    assert(q5.get_capacity() == 16);
+
+    int next_in = 0;
+    int next_out = 0;
+    for (int round = 0; round < 100; ++round) {
+        for (int i = 0; i < 7; ++i) q5.push(next_in++);
+        for (int i = 0; i < 5; ++i) {
+            [[maybe_unused]] const int value = q5.pop();
+            assert(value == next_out);
+            ++next_out;
+        }
+    }
+    assert(q5.get_size() == static_cast<size_t>(next_in - next_out));
+    while (!q5.is_empty()) {
+        [[maybe_unused]] const int value = q5.pop();
+        assert(value == next_out);
+        ++next_out;
+    }
+    assert(next_out == next_in);
+    std::cout << "PASSED" << std::endl;
+
+    // Test 9: Bulk push_range and pop_n
+    std::cout << "Test 9: Bulk operations... ";
+    Queue<std::string> q6;
+    const std::string words[] = {"a", "b", "c", "d", "e"};
+    q6.push_range(std::begin(words), std::end(words));
+    assert(q6.get_size() == 5);
+
+    std::string out[4];
+    assert(q6.pop_n(out, 3) == 3);
+    assert(out[0] == "a" && out[1] == "b" && out[2] == "c");
+    assert(q6.pop_n(out, 4) == 2);
+    assert(out[0] == "d" && out[1] == "e");
+    assert(q6.is_empty());
+    std::cout << "PASSED" << std::endl;
+
+    // Test 10: Truncation and append
+    std::cout << "Test 10: Truncation and append... ";
+    Queue<int> q10;
+    for (int i = 1; i <= 10; i++) q10.push(i);
+    assert(q10.truncate_from(42) == 0);  // No match keeps everything
+    assert(q10.truncate_from(8) == 3);
+    assert(q10.get_size() == 7);
+    assert(q10.truncate_at(100) == 0);
+    assert(q10.truncate_at(5) == 2);
+    assert(q10.get_size() == 5);
+    q10.push(6);  // Tail is usable right after a cut
+    assert(q10.truncate_from(1) == 6);
+    assert(q10.is_empty());
+
+    Queue<std::string> first;
+    Queue<std::string> second;
+    second.push("a");
+    second.push("b");
+    first.append(std::move(second));  // Empty target takes over the buffer
+    assert(second.is_empty());
+    assert(first.get_size() == 2);
+
+    second.push("c");
+    second.push("d");
+    first.splice(second);
+    assert(second.is_empty());
+    second.push("e");  // Source stays usable
+    first.append(std::move(second));
+    assert(first.get_size() == 5);
+    for (const char* expected : {"a", "b", "c", "d", "e"}) assert(first.pop() == expected);
+    std::cout << "PASSED" << std::endl;
+
+    // Test 11: Copy, move and swap
+    std::cout << "Test 11: Copy, move and swap... ";
+    static_assert(std::is_nothrow_move_constructible_v<Queue<std::string>>);
+    static_assert(std::is_nothrow_move_assignable_v<Queue<std::string>>);
+    Queue<int> wrapped;
+    for (int i = 0; i < 12; ++i) wrapped.push(i);
+    for (int i = 0; i < 10; ++i) wrapped.pop();
+    for (int i = 12; i < 20; ++i) wrapped.push(i);  // Contents wrap around the ring
+    Queue<int> wrapped_copy(wrapped);
+    assert(wrapped_copy.get_size() == 10);
+    for (int i = 10; i < 20; ++i) assert(wrapped_copy.pop() == i);
+    assert(wrapped.get_size() == 10);
+
+    Queue<std::string> strings;
+    for (int i = 0; i < 100; ++i) strings.push(std::to_string(i));
+    Queue<std::string> strings_copy;
+    strings_copy = strings;
+    Queue<std::string> moved(std::move(strings));
+    assert(strings.is_empty() && strings.get_capacity() == 0);
+    strings.push("reused");  // Moved-from queue stays usable
+    swap(strings, moved);
+    assert(moved.pop() == "reused");
+    std::vector<Queue<std::string>> queues;
+    queues.push_back(std::move(strings));
+    queues.push_back(std::move(strings_copy));
+    for (int i = 0; i < 100; ++i) {
+        assert(queues[0].pop() == std::to_string(i));
+        assert(queues[1].pop() == std::to_string(i));
+    }
+    std::cout << "PASSED" << std::endl;
+
+    // Test 12: Iterators and ranges
+    std::cout << "Test 12: Iterators and ranges... ";
+    static_assert(std::forward_iterator<Queue<int>::const_iterator>);
+    static_assert(std::ranges::forward_range<const Queue<std::string>>);
+    Queue<int> ring;
+    assert(ring.begin() == ring.end());
+    for (int i = 0; i < 12; ++i) ring.push(i);
+    for (int i = 0; i < 10; ++i) ring.pop();
+    for (int i = 12; i < 20; ++i) ring.push(i);  // Wraps around the buffer end
+    const int in_order[] = {10, 11, 12, 13, 14, 15, 16, 17, 18, 19};
+    assert(std::ranges::equal(ring, in_order));
+    assert(std::ranges::distance(ring) == 10);
+    assert(std::ranges::find(ring, 15) != ring.end());
+    assert(std::ranges::find(ring, 5) == ring.end());
+    std::vector<int> exported(ring.begin(), ring.end());
+    assert(exported.size() == ring.get_size());
+    std::cout << "PASSED" << std::endl;
+
+    // Test 13: Buffered dump
+    std::cout << "Test 13: Dump... ";
+    std::ostringstream dumped;
+    ring.dump(dumped, 3);
+    assert(dumped.str() == "10 11 12 ... (7 more)");
+    dumped.str("");
+    Queue<std::string> greek;
+    greek.push("alpha");
+    greek.push("beta");
+    greek.dump(dumped);
+    greek.dump(dumped, 0);
+    assert(dumped.str() == "alpha beta ... (2 more)");
+    dumped.str("");
+    Queue<char> chars;
+    chars.push('x');
+    chars.push('y');
+    chars.dump(dumped);
+    assert(dumped.str() == "x y ");
+
+#ifndef _WIN32
+    int fds[2];
+    if (pipe(fds) != 0) throw std::runtime_error("pipe() failed");
+    ring.dump_to(fds[1]);
+    close(fds[1]);
+    char piped[64] = {};
+    size_t got = 0;
+    for (ssize_t n; (n = read(fds[0], piped + got, sizeof(piped) - 1 - got)) > 0;) got += static_cast<size_t>(n);
+    close(fds[0]);
+    assert(std::string(piped, got) == "10 11 12 13 14 15 16 17 18 19 ");
+#endif
+    std::cout << "PASSED" << std::endl;
+
+    // Test 14: Binary snapshots
+    std::cout << "Test 14: Save and load... ";
+    std::stringstream snapshot;
+    ring.save(snapshot);  // Wrapped ring is written in FIFO order
+    Queue<int> restored;
+    restored.load(snapshot);
+    assert(std::ranges::equal(restored, in_order));
+
+    Queue<std::string> lines;
+    for (int i = 0; i < 1000; ++i) lines.push("line " + std::to_string(i));
+    const auto path = std::filesystem::temp_directory_path() / "lab3_queue_snapshot.bin";
+    lines.save(path);
+    Queue<std::string> lines_restored;
+    lines_restored.load(path);
+    std::filesystem::remove(path);
+    assert(std::ranges::equal(lines_restored, lines));
+
+    // A stack snapshot is not a queue snapshot
+    std::stringstream other_kind;
+    Stack<int>().save(other_kind);
+    try {
+        restored.load(other_kind);
+        assert(false);
+    } catch (const std::runtime_error&) {}
+    std::stringstream empty_snapshot;
+    Queue<int>().save(empty_snapshot);
+    restored.load(empty_snapshot);
+    assert(restored.is_empty());
+
+    // A forged count fails as a truncated snapshot instead of being allocated
+    std::string forged = empty_snapshot.str();
+    forged.replace(forged.size() - 8, 8, 8, '\xff');  // The count ends the header
+    std::stringstream forged_snapshot(forged);
+    restored.push(7);
+    try {
+        restored.load(forged_snapshot);
+        assert(false);
+    } catch (const std::runtime_error&) {}
+    assert(restored.get_size() == 1);
+    std::cout << "PASSED" << std::endl;
+
+    // Test 15: Statistics policy
+    std::cout << "Test 15: Statistics... ";
+    static_assert(!CountsStats<Queue<int>> && CountsStats<Queue<int, HeapAllocator, CountingStats>>);
+    Queue<int, HeapAllocator, CountingStats> counted;
+    for (int i = 0; i < 100; ++i) counted.push(i);
+    ContainerStats st = counted.stats();
+    assert(st.allocations == 4); // 16, 32, 64, 128
+    assert(st.frees == 3);
+    assert(st.high_water_size == 100);
+    assert(st.bytes_in_use == 128 * sizeof(int));
+    assert(st.high_water_bytes == (64 + 128) * sizeof(int)); // both buffers live while growing
+    assert(counted.truncate_from(90) == 10);
+    assert(counted.truncate_from(1000) == 0);
+    st = counted.stats();
+    assert(st.comparisons == 91 + 90);
+    assert(st.traversals == 2);
+    assert(st.longest_traversal == 91);
+    counted.reset_stats();
+    for (int i = 0; i < 10; ++i) counted.pop();
+    st = counted.stats();
+    assert(st.allocations == 0 && st.comparisons == 0);
+    assert(st.high_water_size == 90);
+    assert(st.high_water_bytes == st.bytes_in_use);
+    std::cout << "PASSED" << std::endl;
+
     std::cout << "\n=== All Queue tests PASSED! ===" << std::endl;
 }
\ No newline at end of file
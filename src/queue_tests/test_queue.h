@@ -7,5 +7,9 @@
 
 void run_tests_queue();
 void run_demo_queue();
+void run_tests_mpmc_queue();
+void run_tests_spsc_queue();
+void run_tests_mmap_queue();
+void run_tests_spill_queue();
 
 #endif //TEST_QUEUE_H
@@ -0,0 +1,124 @@
+#include <cassert>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include "queue/spill_queue.h"
+#include "test_queue.h"
+
+void run_tests_spill_queue() {
+    std::cout << "=== Running Spill Queue Tests ===" << std::endl;
+    const auto directory = std::filesystem::temp_directory_path() / "lab3_spill_test";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    constexpr int NUM_ELEMENTS = 20000;
+
+    // Test 1: Small queues never touch the disk
+    std::cout << "Test 1: Stays in memory under budget... ";
+    {
+        SpillQueue<int> q(1000, directory);
+        for (int i = 0; i < 400; ++i) q.push(i);
+        assert(q.get_on_disk() == 0);
+        assert(q.get_segment_count() == 0);
+        for (int i = 0; i < 400; ++i) assert(q.pop() == i);
+        assert(q.is_empty());
+        try {
+            q.pop();
+            assert(false);
+        } catch (const std::out_of_range&) {}
+    }
+    assert(std::filesystem::is_empty(directory));
+    std::cout << "PASSED" << std::endl;
+
+    // Test 2: A burst spills, FIFO order holds and RAM stays within budget
+    std::cout << "Test 2: Burst over budget... ";
+    {
+        SpillQueue<std::string> q(256, directory);
+        for (int i = 0; i < NUM_ELEMENTS; ++i) {
+            q.push("item " + std::to_string(i));
+            assert(q.get_in_memory() <= q.get_budget());
+        }
+        assert(q.get_size() == NUM_ELEMENTS);
+        assert(q.get_on_disk() > 0);
+        assert(q.get_on_disk() % (q.get_budget() / 4) == 0);  // Only whole segments
+        assert(q.get_segment_count() > 0);
+        for (int i = 0; i < NUM_ELEMENTS; ++i) {
+            assert(q.peek_head() == "item " + std::to_string(i));
+            [[maybe_unused]] const std::string value = q.pop();
+            assert(value == "item " + std::to_string(i));
+            assert(q.get_in_memory() <= q.get_budget());
+        }
+        assert(q.is_empty());
+    }
+    assert(std::filesystem::is_empty(directory));
+    std::cout << "PASSED" << std::endl;
+
+    // Test 3: A queue held under its budget stays in RAM however long it runs
+    std::cout << "Test 3: Steady state under budget... ";
+    {
+        SpillQueue<int> q(1000, directory);
+        int pushed = 0;
+        int popped = 0;
+        while (pushed < 600) q.push(pushed++);
+        for (int i = 0; i < 100000; ++i) {
+            q.push(pushed++);
+            [[maybe_unused]] const int value = q.pop();
+            assert(value == popped);
+            ++popped;
+        }
+        assert(q.get_size() == 600);
+        assert(q.get_segment_count() == 0);
+        assert(std::filesystem::is_empty(directory));
+    }
+    std::cout << "PASSED" << std::endl;
+
+    // Test 4: Interleaved producer and consumer, drop with data still on disk
+    std::cout << "Test 4: Steady state and cleanup... ";
+    {
+        SpillQueue<int> q(64, directory);
+        int pushed = 0;
+        int popped = 0;
+        for (int round = 0; round < 200; ++round) {
+            for (int i = 0; i < 50; ++i) q.push(pushed++);
+            for (int i = 0; i < 30; ++i) {
+                [[maybe_unused]] const int value = q.pop();
+                assert(value == popped);
+                ++popped;
+            }
+        }
+        assert(q.get_size() == static_cast<size_t>(pushed - popped));
+        while (popped < pushed - 500) {
+            [[maybe_unused]] const int value = q.pop();
+            assert(value == popped);
+            ++popped;
+        }
+        assert(!std::filesystem::is_empty(directory));
+    }
+    assert(std::filesystem::is_empty(directory));
+    std::cout << "PASSED" << std::endl;
+
+    // Test 5: An unreadable segment is dropped, not counted forever
+    std::cout << "Test 5: Corrupt segment... ";
+    {
+        SpillQueue<int> q(8, directory);
+        for (int i = 0; i < 100; ++i) q.push(i);
+        for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+            std::filesystem::resize_file(entry.path(), 0);
+        }
+        [[maybe_unused]] int failures = 0;
+        for (int guard = 0; guard < 1000 && !q.is_empty(); ++guard) {
+            try {
+                q.pop();
+            } catch (const std::runtime_error&) {
+                ++failures;
+            }
+        }
+        assert(q.is_empty());
+        assert(failures > 0);
+        assert(std::filesystem::is_empty(directory));
+    }
+    std::filesystem::remove_all(directory);
+    std::cout << "PASSED" << std::endl;
+
+    std::cout << "\n=== All Spill Queue tests PASSED! ===" << std::endl;
+}
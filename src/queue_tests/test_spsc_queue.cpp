@@ -0,0 +1,97 @@
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "queue/spsc_queue.h"
+#include "test_queue.h"
+
+void run_tests_spsc_queue() {
+    std::cout << "=== Running SPSC Queue Tests ===" << std::endl;
+
+    // Test 1: Single-threaded FIFO, bounds and batches
+    std::cout << "Test 1: FIFO, bounds and batches... ";
+    SpscQueue<std::string> q(5);
+    assert(q.get_capacity() == 8);
+    assert(q.is_empty());
+
+    const std::string words[] = {"a", "b", "c", "d", "e", "f"};
+    assert(q.try_push_n(words, 6) == 6);
+    assert(q.try_push("g"));
+    assert(q.try_push("h"));
+    assert(!q.try_push("overflow"));
+    assert(q.try_push_n(words, 6) == 0);
+
+    std::string out[8];
+    assert(q.try_pop_n(out, 3) == 3);
+    assert(out[0] == "a" && out[2] == "c");
+    assert(q.try_push_n(words, 6) == 3);  // Wraps around the ring
+    assert(q.get_size() == 8);
+    assert(q.try_pop_n(out, 8) == 8);
+    assert(out[0] == "d" && out[4] == "h" && out[5] == "a" && out[7] == "c");
+    assert(!q.try_pop(out[0]));
+    std::cout << "PASSED" << std::endl;
+
+    // Test 2: One producer and one consumer thread
+    std::cout << "Test 2: Producer/consumer handoff... ";
+    constexpr int NUM_ELEMENTS = 1000000;
+    constexpr int BATCH = 32;
+    SpscQueue<int> pipe(1024);
+
+    std::thread producer([&pipe] {
+        int batch[BATCH];
+        int next = 0;
+        while (next < NUM_ELEMENTS) {
+            if (next % 3 == 0) {
+                pipe.push(next++);
+                continue;
+            }
+            int count = 0;
+            while (count < BATCH && next + count < NUM_ELEMENTS) {
+                batch[count] = next + count;
+                ++count;
+            }
+            const size_t sent = pipe.try_push_n(batch, count);
+            next += static_cast<int>(sent);
+            if (sent == 0) std::this_thread::yield();
+        }
+    });
+
+    int expected = 0;
+    int batch[BATCH];
+    while (expected < NUM_ELEMENTS) {
+        if (expected % 2 == 0) {
+            [[maybe_unused]] const int value = pipe.pop();
+            assert(value == expected);
+            ++expected;
+            continue;
+        }
+        const size_t got = pipe.try_pop_n(batch, BATCH);
+        for (size_t i = 0; i < got; ++i) {
+            assert(batch[i] == expected);
+            ++expected;
+        }
+        if (got == 0) std::this_thread::yield();
+    }
+    producer.join();
+    assert(pipe.is_empty());
+    std::cout << "PASSED" << std::endl;
+
+    // Test 3: Elements aligned past what plain operator new guarantees
+    std::cout << "Test 3: Over-aligned elements... ";
+    struct alignas(128) Wide {
+        int value;
+    };
+    SpscQueue<Wide> wide(4);
+    for (int i = 0; i < 4; ++i) {
+        [[maybe_unused]] const bool pushed = wide.try_push(Wide{i});
+        assert(pushed);
+    }
+    Wide got{};
+    for (int i = 0; i < 4; ++i) {
+        [[maybe_unused]] const bool popped = wide.try_pop(got);
+        assert(popped && got.value == i);
+    }
+    std::cout << "PASSED" << std::endl;
+
+    std::cout << "\n=== All SPSC Queue tests PASSED! ===" << std::endl;
+}
@@ -0,0 +1,127 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <thread>
+
+#include "queue/mpmc_queue.h"
+#include "work_stealing_deque.h"
+
+/*
+ * Work-stealing executor.
+ * Each worker owns a WorkStealingDeque. Tasks submitted from a worker
+ * (subtasks) go to the bottom of its own deque and run LIFO while
+ * they are cache-hot. Tasks submitted from outside go through a shared
+ * MpmcQueue. An idle worker checks its own deque first, then the shared
+ * queue, then steals the oldest task of a random victim
+ */
+
+class ThreadPool {
+    private:
+    struct Task {
+        std::function<void()> fn;
+    };
+
+    struct Worker {
+        WorkStealingDeque<Task*> deque;
+        std::thread thread;
+    };
+
+    static constexpr size_t injection_capacity = 4096;
+
+    Worker* workers;
+    size_t worker_count;
+    MpmcQueue<Task*> injected;
+    std::atomic<size_t> pending;
+    std::atomic<bool> stopping;
+
+    // Which pool and worker the current thread belongs to, if any
+    struct Current {
+        ThreadPool* pool = nullptr;
+        size_t index = 0;
+    };
+
+    static Current& current() {
+        static thread_local Current c;
+        return c;
+    }
+
+    static void run(Task* task, std::atomic<size_t>& counter) {
+        task->fn();
+        delete task;
+        counter.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    bool find_task(const size_t self, Task*& task, size_t& seed) {
+        if (workers[self].deque.pop(task)) return true;
+        if (injected.try_pop(task)) return true;
+        for (size_t attempt = 0; attempt < worker_count; ++attempt) {
+            seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+            const size_t victim = (seed >> 33) % worker_count;
+            if (victim != self && workers[victim].deque.steal(task)) return true;
+        }
+        return false;
+    }
+
+    void worker_loop(const size_t self) {
+        current() = Current{this, self};
+        size_t seed = self + 1;
+        size_t idle_rounds = 0;
+        Task* task;
+        while (true) {
+            if (find_task(self, task, seed)) {
+                run(task, pending);
+                idle_rounds = 0;
+                continue;
+            }
+            if (stopping.load(std::memory_order_acquire) && pending.load(std::memory_order_acquire) == 0) break;
+            // Back off: spin politely first, then sleep so idle pools don't burn a core
+            if (++idle_rounds < 64) std::this_thread::yield();
+            else std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+        current() = Current{};
+    }
+
+    public:
+    explicit ThreadPool(const size_t threads = std::thread::hardware_concurrency())
+        : worker_count(threads > 0 ? threads : 1), injected(injection_capacity), pending(0), stopping(false) {
+        workers = new Worker[worker_count];
+        for (size_t i = 0; i < worker_count; ++i) {
+            workers[i].thread = std::thread([this, i] { worker_loop(i); });
+        }
+    }
+
+    // Finishes every submitted task, including subtasks they spawn
+    ~ThreadPool() {
+        stopping.store(true, std::memory_order_release);
+        for (size_t i = 0; i < worker_count; ++i) workers[i].thread.join();
+        delete[] workers;
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ThreadPool(ThreadPool&&) = delete;
+    ThreadPool& operator=(ThreadPool&&) = delete;
+
+    [[nodiscard]] size_t get_thread_count() const { return worker_count; }
+
+    // Tasks submitted or spawned but not finished yet
+    [[nodiscard]] size_t get_pending() const { return pending.load(std::memory_order_acquire); }
+
+    void submit(std::function<void()> fn) {
+        auto task = new Task{static_cast<std::function<void()>&&>(fn)};
+        pending.fetch_add(1, std::memory_order_acq_rel);
+        const Current& c = current();
+        if (c.pool == this) workers[c.index].deque.push(task);
+        else injected.push(task);
+    }
+
+    // Block the caller until no task is left. Must not be called from a worker
+    void wait_idle() const {
+        while (pending.load(std::memory_order_acquire) != 0) std::this_thread::yield();
+    }
+};
+
+#endif //THREAD_POOL_H
@@ -0,0 +1,129 @@
+#ifndef WORK_STEALING_DEQUE_H
+#define WORK_STEALING_DEQUE_H
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+/*
+ * Chase-Lev work-stealing deque.
+ * The owner thread pushes and pops at the bottom like Stack<E>,
+ * any other thread steals from the top like Queue<E>::pop.
+ * Owner operations are plain loads/stores except when the deque
+ * is down to its last element; thieves race on top with a CAS.
+ * The ring grows on demand. Old rings are kept until destruction,
+ * because a thief may still be reading one
+ */
+
+template<typename E>
+class WorkStealingDeque {
+    static_assert(std::is_trivially_copyable_v<E>, "Store pointers or handles, slots are read racily by thieves");
+
+    private:
+    static constexpr size_t cache_line = 64;
+
+    struct Ring {
+        size_t mask;
+        Ring* retired; // previous, smaller ring
+        std::atomic<E>* slots;
+
+        Ring(const size_t capacity, Ring* prev) : mask(capacity - 1), retired(prev),
+                                                  slots(new std::atomic<E>[capacity]) {}
+        ~Ring() { delete[] slots; }
+
+        [[nodiscard]] size_t capacity() const { return mask + 1; }
+        E get(const long long i) const { return slots[static_cast<size_t>(i) & mask].load(std::memory_order_relaxed); }
+        void put(const long long i, const E e) { slots[static_cast<size_t>(i) & mask].store(e, std::memory_order_relaxed); }
+    };
+
+    alignas(cache_line) std::atomic<long long> top;
+    alignas(cache_line) std::atomic<long long> bottom;
+    std::atomic<Ring*> ring;
+
+    Ring* grow(Ring* old, const long long b, const long long t) {
+        auto fresh = new Ring(old->capacity() * 2, old);
+        for (long long i = t; i < b; ++i) fresh->put(i, old->get(i));
+        ring.store(fresh, std::memory_order_release);
+        return fresh;
+    }
+
+    public:
+    explicit WorkStealingDeque(const size_t capacity = 64) : top(0), bottom(0) {
+        size_t rounded = 2;
+        while (rounded < capacity) rounded *= 2;
+        ring.store(new Ring(rounded, nullptr), std::memory_order_relaxed);
+    }
+
+    ~WorkStealingDeque() {
+        Ring* r = ring.load(std::memory_order_relaxed);
+        while (r != nullptr) {
+            const Ring* temp = r;
+            r = r->retired;
+            delete temp;
+        }
+    }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+    WorkStealingDeque(WorkStealingDeque&&) = delete;
+    WorkStealingDeque& operator=(WorkStealingDeque&&) = delete;
+
+    // Only a snapshot when called concurrently
+    [[nodiscard]] size_t get_size() const {
+        const long long b = bottom.load(std::memory_order_relaxed);
+        const long long t = top.load(std::memory_order_relaxed);
+        return b > t ? static_cast<size_t>(b - t) : 0;
+    }
+
+    [[nodiscard]] bool is_empty() const { return get_size() == 0; }
+
+    // === Owner only ===
+    void push(const E e) {
+        const long long b = bottom.load(std::memory_order_relaxed);
+        const long long t = top.load(std::memory_order_acquire);
+        Ring* r = ring.load(std::memory_order_relaxed);
+        if (b - t >= static_cast<long long>(r->capacity())) r = grow(r, b, t);
+        r->put(b, e);
+        bottom.store(b + 1, std::memory_order_release);
+    }
+
+    // Newest element first, false if empty or the last one was stolen
+    bool pop(E& out) {
+        const long long b = bottom.load(std::memory_order_relaxed) - 1;
+        Ring* r = ring.load(std::memory_order_relaxed);
+        // seq_cst store/load pair: a thief must see the reservation before we look at top
+        bottom.store(b, std::memory_order_seq_cst);
+        long long t = top.load(std::memory_order_seq_cst);
+
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        out = r->get(b);
+        if (t == b) {
+            // Last element: race the thieves for it
+            const bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                         std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    // === Any thread ===
+    // Oldest element first, false if empty or another thread won the race
+    bool steal(E& out) {
+        long long t = top.load(std::memory_order_seq_cst);
+        const long long b = bottom.load(std::memory_order_seq_cst);
+        if (t >= b) return false;
+
+        Ring* r = ring.load(std::memory_order_acquire);
+        const E e = r->get(t);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return false;
+        }
+        out = e;
+        return true;
+    }
+};
+
+#endif //WORK_STEALING_DEQUE_H
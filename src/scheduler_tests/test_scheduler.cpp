@@ -0,0 +1,113 @@
+#include "test_scheduler.h"
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "scheduler/thread_pool.h"
+#include "scheduler/work_stealing_deque.h"
+
+namespace {
+    // Sum of [from, to) split recursively into subtasks until ranges are small
+    void parallel_sum(ThreadPool& pool, const long long from, const long long to, std::atomic<long long>& sum) {
+        if (to - from <= 1000) {
+            long long local = 0;
+            for (long long i = from; i < to; ++i) local += i;
+            sum.fetch_add(local, std::memory_order_relaxed);
+            return;
+        }
+        const long long mid = from + (to - from) / 2;
+        pool.submit([&pool, from, mid, &sum] { parallel_sum(pool, from, mid, sum); });
+        pool.submit([&pool, mid, to, &sum] { parallel_sum(pool, mid, to, sum); });
+    }
+}
+
+void run_demo_scheduler() {
+    std::cout << "\n=== Thread Pool Demo ====" << std::endl;
+
+    ThreadPool pool;
+    std::atomic<long long> sum{0};
+    constexpr long long N = 10000000;
+    pool.submit([&pool, &sum] { parallel_sum(pool, 0, N, sum); });
+    pool.wait_idle();
+
+    std::cout << "Workers: " << pool.get_thread_count() << std::endl;
+    std::cout << "Sum of 0.." << N - 1 << " = " << sum.load() << std::endl;
+}
+
+void run_tests_scheduler() {
+    std::cout << "=== Running Scheduler Tests ===" << std::endl;
+
+    // Test 1: Owner end is LIFO, thief end is FIFO
+    std::cout << "Test 1: Deque ends... ";
+    WorkStealingDeque<int> d(2);
+    assert(d.is_empty());
+    for (int i = 1; i <= 10; ++i) d.push(i);  // Grows past the initial ring
+    assert(d.get_size() == 10);
+
+    int value;
+    assert(d.pop(value) && value == 10);
+    assert(d.steal(value) && value == 1);
+    assert(d.steal(value) && value == 2);
+    assert(d.pop(value) && value == 9);
+    for (int i = 8; i >= 3; --i) assert(d.pop(value) && value == i);
+    assert(!d.pop(value));
+    assert(!d.steal(value));
+    std::cout << "PASSED" << std::endl;
+
+    // Test 2: Owner pops while thieves steal, every element taken once
+    std::cout << "Test 2: Concurrent stealing... ";
+    constexpr int NUM_ELEMENTS = 200000;
+    WorkStealingDeque<int> shared;
+    std::atomic<bool> done{false};
+    const unsigned hw = std::thread::hardware_concurrency();
+    const int thieves = hw < 2 ? 2 : (hw > 8 ? 8 : static_cast<int>(hw));
+    std::vector<std::vector<int>> stolen(thieves);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < thieves; ++t) {
+        workers.emplace_back([&shared, &done, &stolen, t] {
+            int v;
+            while (!done.load(std::memory_order_acquire)) {
+                if (shared.steal(v)) stolen[t].push_back(v);
+                else std::this_thread::yield();
+            }
+        });
+    }
+
+    std::vector<int> owned;
+    for (int i = 0; i < NUM_ELEMENTS; ++i) {
+        shared.push(i);
+        if (i % 3 == 0 && shared.pop(value)) owned.push_back(value);
+    }
+    while (!shared.is_empty()) {
+        if (shared.pop(value)) owned.push_back(value);
+    }
+    done.store(true, std::memory_order_release);
+    for (auto& worker : workers) worker.join();
+
+    std::vector<int> seen(NUM_ELEMENTS, 0);
+    for (const int v : owned) ++seen[v];
+    for (const auto& values : stolen) {
+        for (const int v : values) ++seen[v];
+    }
+    for (const int count : seen) assert(count == 1);
+    std::cout << "PASSED" << std::endl;
+
+    // Test 3: Thread pool runs every task and subtask
+    std::cout << "Test 3: Thread pool with subtasks... ";
+    {
+        ThreadPool pool(4);
+        assert(pool.get_thread_count() == 4);
+        std::atomic<long long> sum{0};
+        pool.submit([&pool, &sum] { parallel_sum(pool, 0, 1000000, sum); });
+        for (int i = 0; i < 1000; ++i) {
+            pool.submit([&sum] { sum.fetch_add(1, std::memory_order_relaxed); });
+        }
+        pool.wait_idle();
+        assert(pool.get_pending() == 0);
+        assert(sum.load() == 999999LL * 1000000 / 2 + 1000);
+    }
+    std::cout << "PASSED" << std::endl;
+
+    std::cout << "\n=== All Scheduler tests PASSED! ===" << std::endl;
+}
@@ -0,0 +1,7 @@
+#ifndef TEST_SCHEDULER_H
+#define TEST_SCHEDULER_H
+
+void run_tests_scheduler();
+void run_demo_scheduler();
+
+#endif //TEST_SCHEDULER_H
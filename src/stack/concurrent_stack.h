@@ -0,0 +1,182 @@
+#ifndef CONCURRENT_STACK_H
+#define CONCURRENT_STACK_H
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+
+/*
+ * Lock-free Treiber stack with hazard pointers.
+ * Push and pop CAS the head. Before dereferencing the head, pop
+ * publishes it in a hazard slot. A popped node is only freed once
+ * no slot points to it. That gives safe reclamation and also rules
+ * out ABA: a node that is still referenced can't be freed and reused,
+ * so a head that compares equal really is the same node
+ */
+
+template<typename E>
+class ConcurrentStack {
+    private:
+    static constexpr size_t cache_line = 64;
+    static constexpr size_t max_slots = 64;
+    // Scan hazards once a slot holds this many retired nodes
+    static constexpr size_t retire_threshold = 2 * max_slots;
+
+    struct Node {
+        E data;
+        Node* next;
+        Node* retired_next;
+
+        explicit Node(const E& d) : data(d), next(nullptr), retired_next(nullptr) {}
+        explicit Node(E&& d) : data(static_cast<E&&>(d)), next(nullptr), retired_next(nullptr) {}
+    };
+
+    // Claimed by one popping thread at a time, the retired list travels with the slot
+    struct alignas(cache_line) HazardSlot {
+        std::atomic<Node*> hazard{nullptr};
+        std::atomic<bool> owned{false};
+        Node* retired = nullptr;
+        size_t retired_count = 0;
+    };
+
+    alignas(cache_line) std::atomic<Node*> head;
+    alignas(cache_line) std::atomic<size_t> size;
+    HazardSlot slots[max_slots];
+
+    HazardSlot& acquire_slot() {
+        static thread_local size_t hint = std::hash<std::thread::id>{}(std::this_thread::get_id());
+        while (true) {
+            for (size_t i = 0; i < max_slots; ++i) {
+                HazardSlot& slot = slots[(hint + i) % max_slots];
+                if (!slot.owned.load(std::memory_order_relaxed) &&
+                    !slot.owned.exchange(true, std::memory_order_acquire)) {
+                    hint = (hint + i) % max_slots;
+                    return slot;
+                }
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    static void release_slot(HazardSlot& slot) {
+        slot.hazard.store(nullptr, std::memory_order_release);
+        slot.owned.store(false, std::memory_order_release);
+    }
+
+    // Free every retired node of the slot that no other thread is looking at
+    void scan(HazardSlot& slot) {
+        Node* protected_nodes[max_slots];
+        size_t count = 0;
+        for (auto& other : slots) {
+            if (Node* p = other.hazard.load(std::memory_order_seq_cst)) protected_nodes[count++] = p;
+        }
+
+        Node* keep = nullptr;
+        size_t kept = 0;
+        Node* node = slot.retired;
+        while (node != nullptr) {
+            Node* next = node->retired_next;
+            bool in_use = false;
+            for (size_t i = 0; i < count && !in_use; ++i) in_use = protected_nodes[i] == node;
+            if (in_use) {
+                node->retired_next = keep;
+                keep = node;
+                ++kept;
+            } else {
+                delete node;
+            }
+            node = next;
+        }
+        slot.retired = keep;
+        slot.retired_count = kept;
+    }
+
+    void link(Node* node) {
+        // Count first, so a racing pop never takes the counter below zero
+        size.fetch_add(1, std::memory_order_relaxed);
+        node->next = head.load(std::memory_order_relaxed);
+        while (!head.compare_exchange_weak(node->next, node,
+                                           std::memory_order_release, std::memory_order_relaxed)) {}
+    }
+
+    public:
+    // Constructor
+    explicit ConcurrentStack() : head(nullptr), size(0) {}
+    // Destructor, no other thread may touch the stack any more
+    ~ConcurrentStack() {
+        Node* node = head.load(std::memory_order_acquire);
+        while (node != nullptr) {
+            const Node* temp = node;
+            node = node->next;
+            delete temp;
+        }
+        for (auto& slot : slots) {
+            for (Node* retired = slot.retired; retired != nullptr;) {
+                const Node* temp = retired;
+                retired = retired->retired_next;
+                delete temp;
+            }
+        }
+    }
+    // Prohibit assignment and movement
+    ConcurrentStack(const ConcurrentStack&) = delete;
+    ConcurrentStack& operator=(const ConcurrentStack&) = delete;
+    ConcurrentStack(ConcurrentStack&&) = delete;
+    ConcurrentStack& operator=(ConcurrentStack&&) = delete;
+
+    // === Basic operations ===
+    // Only a snapshot when called concurrently
+    [[nodiscard]] bool is_empty() const { return head.load(std::memory_order_acquire) == nullptr; }
+
+    [[nodiscard]] size_t get_size() const { return size.load(std::memory_order_relaxed); }
+
+    void push(const E& e) {
+        link(new Node(e));
+    }
+
+    void push(E&& e) {
+        link(new Node(static_cast<E&&>(e)));
+    }
+
+    // False if the stack was empty
+    bool try_pop(E& out) {
+        HazardSlot& slot = acquire_slot();
+        Node* node = head.load(std::memory_order_acquire);
+        while (node != nullptr) {
+            // Publish, then make sure the node was still on top when published
+            slot.hazard.store(node, std::memory_order_seq_cst);
+            Node* current = head.load(std::memory_order_seq_cst);
+            if (current != node) {
+                node = current;
+                continue;
+            }
+            if (head.compare_exchange_weak(node, node->next,
+                                           std::memory_order_acq_rel, std::memory_order_acquire)) {
+                break;
+            }
+        }
+        slot.hazard.store(nullptr, std::memory_order_release);
+
+        if (node == nullptr) {
+            release_slot(slot);
+            return false;
+        }
+
+        size.fetch_sub(1, std::memory_order_relaxed);
+        out = static_cast<E&&>(node->data);
+        node->retired_next = slot.retired;
+        slot.retired = node;
+        if (++slot.retired_count >= retire_threshold) scan(slot);
+        release_slot(slot);
+        return true;
+    }
+
+    [[maybe_unused]] E pop() {
+        E result;
+        if (!try_pop(result)) throw std::out_of_range("Stack is empty");
+        return result;
+    }
+};
+
+#endif //CONCURRENT_STACK_H
@@ -4,45 +4,219 @@
 
 #ifndef STACK_H
 #define STACK_H
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <new>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "allocator/allocator.h"
+#include "io/dump_writer.h"
+#include "io/snapshot.h"
+#include "stats/stats.h"
 
 /*
  * Without STL objects may
  * remain in memory when we copy them
  */
 
-template<typename E>
+/*
+ * Unrolled storage: elements live in fixed-size blocks
+ * linked from the top block down. Every block below the top one is full.
+ * One emptied block is kept as a spare, so push/pop around
+ * a block boundary never goes to the allocator.
+ * Blocks come from the Alloc policy (see allocator/allocator.h),
+ * the Stats policy may count them (see stats/stats.h)
+ */
+
+template<typename E, typename Alloc = HeapAllocator, typename Stats = NoStats>
 class Stack {
     private:
-    struct Node {
-        E data;
-        Node* next;
+    static constexpr size_t block_capacity = sizeof(E) >= 512 ? 8 : 4096 / sizeof(E);
 
-        explicit Node(const E& d) : data(d), next(nullptr) {}
-        explicit Node(E&& d) : data(static_cast<E&&>(d)), next(nullptr) {}
-        ~Node() = default;
+    struct Block {
+        Block* below;
+        alignas(E) unsigned char storage[block_capacity * sizeof(E)];
+
+        explicit Block(Block* b) : below(b) {}
+        E* items() { return reinterpret_cast<E*>(storage); }
+        const E* items() const { return reinterpret_cast<const E*>(storage); }
     };
 
     size_t size;
-    Node* head;
+    size_t top_count; // elements in the top block
+    Block* top;
+    Block* spare;
+    [[no_unique_address]] Alloc allocator;
+    [[no_unique_address]] mutable Stats counters;
+
+    [[nodiscard]] size_t memory_bytes() const {
+        return ((size + block_capacity - 1) / block_capacity + (spare ? 1 : 0)) * sizeof(Block);
+    }
+
+    Block* new_block() {
+        Block* block = ::new (allocator.allocate(sizeof(Block), alignof(Block))) Block(nullptr);
+        counters.on_alloc();
+        counters.on_memory(memory_bytes() + sizeof(Block));
+        return block;
+    }
+
+    void free_block(Block* block) {
+        if (block == nullptr) return;
+        allocator.deallocate(block, sizeof(Block), alignof(Block));
+        counters.on_free();
+    }
+
+    void push_block() {
+        Block* block = spare ? spare : new_block();
+        spare = nullptr;
+        block->below = top;
+        top = block;
+        top_count = 0;
+    }
+
+    void pop_block() {
+        Block* block = top;
+        top = top->below;
+        top_count = top ? block_capacity : 0;
+        if (spare == nullptr) spare = block;
+        else free_block(block);
+    }
+
+    template<typename T>
+    void emplace(T&& e) {
+        if (top == nullptr || top_count == block_capacity) push_block();
+        ::new (top->items() + top_count) E(static_cast<T&&>(e));
+        ++top_count;
+        size++;
+        counters.on_size(size);
+    }
+
+    // Call f(items, count) for every block from the bottom up
+    template<typename F>
+    void for_each_block_bottom_up(F f) const {
+        if (top == nullptr) return;
+        const size_t block_count = (size + block_capacity - 1) / block_capacity;
+        const std::unique_ptr<const Block*[]> order(new const Block*[block_count]);
+        size_t i = block_count;
+        for (auto block = top; block != nullptr; block = block->below) order[--i] = block;
+        counters.on_traverse(block_count);
+        for (i = 0; i < block_count; ++i) f(order[i]->items(), i + 1 == block_count ? top_count : block_capacity);
+    }
+
+    // Rebuild other's blocks bottom-up, one allocation per block.
+    // Trivially copyable elements are copied a whole block at a time
+    void copy_from(const Stack& other) {
+        other.for_each_block_bottom_up([this](const E* items, const size_t count) {
+            push_block();
+            if constexpr (std::is_trivially_copyable_v<E>) {
+                std::memcpy(static_cast<void*>(top->items()), items, count * sizeof(E));
+                top_count = count;
+                size += count;
+                counters.on_size(size);
+            } else {
+                for (size_t j = 0; j < count; ++j) emplace(items[j]);
+            }
+        });
+    }
 
     public:
+    // Walks from the top down, the order pop would return elements in
+    class const_iterator {
+        private:
+        const Block* block = nullptr;
+        size_t count = 0; // elements of block still ahead, current one included
+
+        public:
+        using iterator_concept = std::forward_iterator_tag;
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = E;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const E*;
+        using reference = const E&;
+
+        const_iterator() = default;
+        const_iterator(const Block* b, const size_t c) : block(b), count(c) {}
+
+        reference operator*() const { return block->items()[count - 1]; }
+        pointer operator->() const { return block->items() + count - 1; }
+
+        const_iterator& operator++() {
+            if (--count == 0) {
+                block = block->below;
+                count = block ? block_capacity : 0;
+            }
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator temp = *this;
+            ++*this;
+            return temp;
+        }
+
+        friend bool operator==(const const_iterator&, const const_iterator&) = default;
+    };
+
+    using iterator = const_iterator;
+
     // Constructor
-    explicit Stack() : size(0), head(nullptr) {}
+    explicit Stack(const Alloc& alloc = Alloc())
+        : size(0), top_count(0), top(nullptr), spare(nullptr), allocator(alloc) {}
     // Destructor
     ~Stack() {
-        while (head != nullptr) {
-            const Node* temp = head;
-            head = head->next;
-            delete temp;
+        // Nothing to run and nothing to free: the arena drops the blocks
+        if constexpr (Alloc::releases_in_bulk && std::is_trivially_destructible_v<E>) return;
+        while (top != nullptr) {
+            E* items = top->items();
+            for (size_t i = 0; i < top_count; ++i) items[i].~E();
+            Block* temp = top;
+            top = top->below;
+            top_count = block_capacity;
+            free_block(temp);
         }
-        head = nullptr;
+        free_block(spare);
+        spare = nullptr;
+    }
+    // Deep copy, shares other's allocator
+    Stack(const Stack& other) : Stack(other.allocator) {
+        copy_from(other);
+    }
+    // Takes over other's blocks, other is left empty
+    Stack(Stack&& other) noexcept
+        : size(other.size), top_count(other.top_count), top(other.top), spare(other.spare),
+          allocator(other.allocator) {
+        other.size = 0;
+        other.top_count = 0;
+        other.top = nullptr;
+        other.spare = nullptr;
+    }
+
+    Stack& operator=(const Stack& other) {
+        if (this != &other) Stack(other).swap(*this);
+        return *this;
+    }
+
+    Stack& operator=(Stack&& other) noexcept {
+        if (this != &other) Stack(static_cast<Stack&&>(other)).swap(*this);
+        return *this;
+    }
+
+    void swap(Stack& other) noexcept {
+        std::swap(size, other.size);
+        std::swap(top_count, other.top_count);
+        std::swap(top, other.top);
+        std::swap(spare, other.spare);
+        std::swap(allocator, other.allocator);
     }
-    // Prohibit assignment and movement
-    Stack(const Stack&) = delete;
-    Stack& operator=(const Stack&) = delete;
-    Stack(Stack&&) = delete;
-    Stack& operator=(Stack&&) = delete;
+
+    friend void swap(Stack& a, Stack& b) noexcept { a.swap(b); }
 
     // === Basic operations ===
     // True if stack is empty
@@ -52,40 +226,97 @@ class Stack {
 
     // Copy existing object
     void push(const E& e) {
-        Node* newNode = new Node(e);
-        newNode->next = head;
-        head = newNode;
-        size++;
+        emplace(e);
     }
     // Move object or move temporary
     void push(E&& e) {
-        Node* newNode = new Node(static_cast<E&&>(e));
-        newNode->next = head;
-        head = newNode;
-        size++;
+        emplace(static_cast<E&&>(e));
     }
 
     [[maybe_unused]] E pop() {
         if (is_empty()) throw std::out_of_range("Stack is empty");
-        Node* temp = head;
-        E result = static_cast<E&&>(temp->data);
-        head = head->next;
-        delete temp;
+        E& last = top->items()[top_count - 1];
+        E result = static_cast<E&&>(last);
+        last.~E();
+        --top_count;
         size--;
+        if (top_count == 0) pop_block();
 
         return result;
     }
 
     [[maybe_unused]] const E& peek() const {
         if (is_empty()) throw std::out_of_range("Stack is empty");
-        return head->data;
+        return top->items()[top_count - 1];
+    }
+
+    // === Statistics (see stats/stats.h) ===
+    [[nodiscard]] ContainerStats stats() const requires Stats::enabled { return counters.snapshot(memory_bytes()); }
+
+    void reset_stats() requires Stats::enabled { counters.reset(size, memory_bytes()); }
+
+    // === Traversal ===
+    [[nodiscard]] const_iterator begin() const { return const_iterator(top, top_count); }
+    [[nodiscard]] const_iterator end() const { return const_iterator(); }
+    [[nodiscard]] const_iterator cbegin() const { return begin(); }
+    [[nodiscard]] const_iterator cend() const { return end(); }
+
+    // === Output ===
+    // Up to limit elements from the top down, a cut is marked with "..."
+    void dump(DumpWriter& out, const size_t limit = DumpWriter::no_limit) const {
+        size_t shown = 0;
+        for (auto it = begin(); it != end() && shown < limit; ++it, ++shown) out << *it << ' ';
+        if (shown < size) out << "... (" << size - shown << " more)";
+    }
+
+    void dump(std::ostream& os, const size_t limit = DumpWriter::no_limit) const {
+        DumpWriter out(os);
+        dump(out, limit);
+    }
+
+    void dump_to(const int fd, const size_t limit = DumpWriter::no_limit) const {
+        DumpWriter out(fd);
+        dump(out, limit);
+    }
+
+    // === Snapshots (see io/snapshot.h) ===
+    // Elements bottom to top, one codec call per block
+    void save(std::ostream& os) const {
+        Snapshot::Writer w(os);
+        Snapshot::write_header<E>(w, Snapshot::Kind::STACK, size);
+        for_each_block_bottom_up([&w](const E* items, const size_t count) {
+            SnapshotCodec<E>::write(w, items, count);
+        });
+    }
+
+    // Replace the contents, elements are read straight into fresh blocks.
+    // The stack is left unchanged if the snapshot is bad
+    void load(std::istream& is) {
+        Snapshot::Reader r(is);
+        uint64_t left = Snapshot::read_header<E>(r, Snapshot::Kind::STACK);
+        Stack fresh(allocator);
+        while (left > 0) {
+            const size_t count = left < block_capacity ? static_cast<size_t>(left) : block_capacity;
+            fresh.push_block();
+            SnapshotCodec<E>::read(r, fresh.top->items(), count);
+            fresh.top_count = count;
+            fresh.size += count;
+            left -= count;
+        }
+        swap(fresh);
+    }
+
+    void save(const std::filesystem::path& path) const {
+        Snapshot::save_file(path, [this](std::ostream& os) { save(os); });
+    }
+
+    void load(const std::filesystem::path& path) {
+        Snapshot::load_file(path, [this](std::istream& is) { load(is); });
     }
 
     void peek_stack() const {
         if (is_empty()) throw std::out_of_range("Stack is empty");
-        for (auto current = head; current != nullptr; current = current->next) {
-            std::cout << current->data << " ";
-        }
+        dump(std::cout);
     }
 };
 
@@ -0,0 +1,65 @@
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "stack/concurrent_stack.h"
+#include "test_stack.h"
+
+void run_tests_concurrent_stack() {
+    std::cout << "=== Running Concurrent Stack Tests ===" << std::endl;
+
+    // Test 1: Single-threaded LIFO
+    std::cout << "Test 1: LIFO and empty stack... ";
+    ConcurrentStack<std::string> s;
+    assert(s.is_empty());
+    s.push("a");
+    s.push(std::string("b"));
+    assert(s.get_size() == 2);
+    assert(s.pop() == "b");
+    assert(s.pop() == "a");
+
+    std::string out;
+    assert(!s.try_pop(out));
+    try {
+        s.pop();
+        assert(false); // Should not reach this point
+    } catch (const std::out_of_range& e) {
+        assert(std::string(e.what()) == "Stack is empty");
+    }
+    std::cout << "PASSED" << std::endl;
+
+    // Test 2: Shared free-list churn from many threads
+    std::cout << "Test 2: Multi-threaded push/pop... ";
+    const unsigned hw = std::thread::hardware_concurrency();
+    const int threads = hw < 2 ? 2 : (hw > 8 ? 8 : static_cast<int>(hw));
+    constexpr int PER_THREAD = 50000;
+
+    ConcurrentStack<int> shared;
+    std::vector<std::vector<int>> taken(threads);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&shared, &taken, t] {
+            int value;
+            for (int i = 0; i < PER_THREAD; ++i) {
+                shared.push(t * PER_THREAD + i);
+                // Pop roughly every other push so nodes get retired while others read them
+                if (i % 2 == 1 && shared.try_pop(value)) taken[t].push_back(value);
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    std::vector<int> seen(threads * PER_THREAD, 0);
+    for (const auto& values : taken) {
+        for (const int v : values) ++seen[v];
+    }
+    int value;
+    while (shared.try_pop(value)) ++seen[value];
+    for (const int count : seen) assert(count == 1);
+    assert(shared.is_empty());
+    assert(shared.get_size() == 0);
+    std::cout << "PASSED" << std::endl;
+
+    std::cout << "\n=== All Concurrent Stack tests PASSED! ===" << std::endl;
+}
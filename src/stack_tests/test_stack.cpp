@@ -2,10 +2,22 @@
 // Created by IWOFLEUR on 20.09.2025.
 //
 #include "test_stack.h"
+#include <algorithm>
 #include <cassert>
+#include <filesystem>
 #include <iostream>
+#include <iterator>
+#include <numeric>
+#include <ranges>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "io/dump_writer.h"
 #include "stack/stack.h"
+#include "stats/stats.h"
 
 void run_demo_stack() {
     std::cout << "\n=== Stack Demo ====" << std::endl;
@@ -21,9 +33,14 @@ void run_demo_stack() {
     std::cout << "Stack size: " << s.get_size() << std::endl;
     std::cout << "Top element: " << s.peek() << std::endl;
 
+    std::cout << "Contents: ";
+    s.dump(std::cout);
+    std::cout << std::endl;
+
     std::cout << "\nExtracting all elements (LIFO order):" << std::endl;
+    DumpWriter out(std::cout);
     while (!s.is_empty()) {
-        std::cout << "Popped: " << s.pop() << std::endl;
+        out << "Popped: " << s.pop() << '\n';
     }
 }
 
@@ -126,5 +143,159 @@ void run_tests_stack() {
     assert(charStack.pop() == 'A');
     std::cout << "PASSED" << std::endl;
 
+    // Test 8: Many elements across block boundaries
+    std::cout << "Test 8: Block boundaries... ";
+    Stack<std::string> s5;
+    constexpr int NUM_ELEMENTS = 5000;
+    for (int i = 0; i < NUM_ELEMENTS; ++i) {
+        s5.push(std::to_string(i));
+        // Oscillate on top of every size, including full blocks
+        s5.push("extra");
+        assert(s5.pop() == "extra");
+    }
+    assert(s5.get_size() == NUM_ELEMENTS);
+
+    for (int i = NUM_ELEMENTS - 1; i >= 0; --i) {
+        assert(s5.peek() == std::to_string(i));
+        assert(s5.pop() == std::to_string(i));
+    }
+    assert(s5.is_empty());
+    std::cout << "PASSED" << std::endl;
+
+    // Test 9: Copy, move and swap
+    std::cout << "Test 9: Copy, move and swap... ";
+    static_assert(std::is_nothrow_move_constructible_v<Stack<std::string>>);
+    static_assert(std::is_nothrow_move_assignable_v<Stack<std::string>>);
+    Stack<std::string> original;
+    for (int i = 0; i < NUM_ELEMENTS; ++i) original.push(std::to_string(i));
+    Stack<std::string> copy(original);
+    assert(copy.get_size() == original.get_size());
+    copy.push("only in copy");
+    assert(original.peek() == std::to_string(NUM_ELEMENTS - 1));
+
+    Stack<std::string> moved(std::move(copy));
+    assert(copy.is_empty());
+    copy.push("reused");  // Moved-from stack stays usable
+    assert(moved.pop() == "only in copy");
+    swap(moved, copy);
+    assert(copy.get_size() == NUM_ELEMENTS);
+    assert(moved.pop() == "reused");
+    copy = original;
+    moved = std::move(copy);
+    for (int i = NUM_ELEMENTS - 1; i >= 0; --i) assert(moved.pop() == std::to_string(i));
+
+    // Trivially copyable elements are copied block by block
+    Stack<int> ints;
+    for (int i = 0; i < NUM_ELEMENTS; ++i) ints.push(i);
+    std::vector<Stack<int>> stacks;
+    stacks.push_back(ints);
+    stacks.push_back(std::move(ints));
+    stacks.emplace_back();
+    assert(stacks[0].get_size() == NUM_ELEMENTS && stacks[1].get_size() == NUM_ELEMENTS);
+    for (int i = NUM_ELEMENTS - 1; i >= 0; --i) assert(stacks[0].pop() == i && stacks[1].pop() == i);
+    assert(stacks[2].is_empty());
+    std::cout << "PASSED" << std::endl;
+
+    // Test 10: Iterators and ranges
+    std::cout << "Test 10: Iterators and ranges... ";
+    static_assert(std::forward_iterator<Stack<int>::const_iterator>);
+    static_assert(std::ranges::forward_range<const Stack<std::string>>);
+    Stack<int> walked;
+    assert(walked.begin() == walked.end());
+    for (int i = 0; i < NUM_ELEMENTS; ++i) walked.push(i);
+    assert(std::ranges::distance(walked) == NUM_ELEMENTS);
+    int expected = NUM_ELEMENTS - 1;
+    for (const int value : walked) assert(value == expected--);  // Top to bottom
+    assert(std::accumulate(walked.begin(), walked.end(), 0LL) == 1LL * NUM_ELEMENTS * (NUM_ELEMENTS - 1) / 2);
+    assert(*std::ranges::find(walked, 4242) == 4242);
+    assert(std::ranges::count_if(walked | std::views::take(10), [](const int v) { return v % 2 == 0; }) == 5);
+    std::cout << "PASSED" << std::endl;
+
+    // Test 11: Buffered dump
+    std::cout << "Test 11: Dump... ";
+    Stack<double> doubles;
+    doubles.push(1.5);
+    doubles.push(-0.25);
+    doubles.push(3);
+    std::ostringstream dumped;
+    doubles.dump(dumped);
+    assert(dumped.str() == "3 -0.25 1.5 ");
+    dumped.str("");
+    doubles.dump(dumped, 1);
+    assert(dumped.str() == "3 ... (2 more)");
+
+    // Output larger than the buffer goes out in several chunks
+    std::ostringstream big;
+    {
+        DumpWriter out(big, 64);
+        walked.dump(out);
+        assert(out.get_buffered() < 64);
+    }
+    std::ostringstream reference;
+    for (const int value : walked) reference << value << ' ';
+    assert(big.str() == reference.str());
+    std::cout << "PASSED" << std::endl;
+
+    // Test 12: Binary snapshots
+    std::cout << "Test 12: Save and load... ";
+    std::stringstream snapshot;
+    walked.save(snapshot);
+    Stack<int> restored;
+    restored.push(-1);  // Replaced by the load
+    restored.load(snapshot);
+    assert(std::ranges::equal(restored, walked));
+
+    Stack<std::string> words;
+    for (int i = 0; i < NUM_ELEMENTS; ++i) words.push(std::string(static_cast<size_t>(i % 13), 'a' + i % 26));
+    words.push("");
+    const auto path = std::filesystem::temp_directory_path() / "lab3_stack_snapshot.bin";
+    words.save(path);
+    Stack<std::string> words_restored;
+    words_restored.load(path);
+    std::filesystem::remove(path);
+    assert(std::ranges::equal(words_restored, words));
+    assert(words_restored.pop().empty());
+
+    // Wrong element type and truncated data are rejected, the target keeps its contents
+    std::stringstream wrong_type;
+    words.save(wrong_type);
+    try {
+        restored.load(wrong_type);
+        assert(false);
+    } catch (const std::runtime_error&) {}
+    std::stringstream truncated(snapshot.str().substr(0, snapshot.str().size() / 2));
+    try {
+        restored.load(truncated);
+        assert(false);
+    } catch (const std::runtime_error&) {}
+    assert(restored.get_size() == walked.get_size());
+    std::cout << "PASSED" << std::endl;
+
+    // Test 13: Statistics policy
+    std::cout << "Test 13: Statistics... ";
+    static_assert(!CountsStats<Stack<int>> && CountsStats<Stack<int, HeapAllocator, CountingStats>>);
+    static_assert(sizeof(Stack<int, HeapAllocator, CountingStats>) > sizeof(Stack<int>));
+    Stack<int, HeapAllocator, CountingStats> counted;
+    for (int i = 0; i < 3000; ++i) counted.push(i);
+    ContainerStats st = counted.stats();
+    assert(st.allocations == 3); // 1024 ints per block
+    assert(st.frees == 0);
+    assert(st.high_water_size == 3000);
+    assert(st.bytes_in_use == st.high_water_bytes);
+    const Stack<int, HeapAllocator, CountingStats> counted_copy(counted);
+    assert(counted_copy.stats().allocations == 3);
+    assert(counted.stats().traversals == 1);
+    assert(counted.stats().longest_traversal == 3);
+    while (!counted.is_empty()) counted.pop();
+    st = counted.stats();
+    assert(st.frees == 2); // the last block stays as the spare
+    assert(st.bytes_in_use * 3 == st.high_water_bytes);
+    counted.reset_stats();
+    st = counted.stats();
+    assert(st.allocations == 0 && st.frees == 0 && st.traversals == 0);
+    assert(st.high_water_size == 0);
+    assert(st.high_water_bytes == st.bytes_in_use);
+    std::cout << "PASSED" << std::endl;
+
     std::cout << "\n=== All Stack tests PASSED! ===" << std::endl;
 }
\ No newline at end of file
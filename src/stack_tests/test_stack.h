@@ -7,5 +7,6 @@
 
 void run_tests_stack();
 void run_demo_stack();
+void run_tests_concurrent_stack();
 
 #endif //TEST_STACK_H
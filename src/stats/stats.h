@@ -0,0 +1,97 @@
+#ifndef STATS_H
+#define STATS_H
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * Statistics policies for Stack, Queue and PriorityQueue.
+ * A policy provides
+ *     static constexpr bool enabled
+ *     on_alloc(), on_free()      - one block/buffer from or to the allocator
+ *     on_compare(n)              - n element or priority comparisons
+ *     on_traverse(steps)         - one walk over steps elements, blocks or heap levels
+ *     on_size(size)              - element count after it grew
+ *     on_memory(bytes)           - bytes held after an allocation
+ *     snapshot(bytes), reset(size, bytes)
+ * NoStats is empty and its hooks are empty inline calls, so the default
+ * containers carry no counters and optimized builds drop every hook.
+ * Counters belong to the container object, not to its storage: swap,
+ * move and load exchange storage and leave the counts where they are.
+ * Bytes in use are read off the storage when a snapshot is taken.
+ * Like the containers, none of this is thread-safe
+ */
+
+struct ContainerStats {
+    uint64_t allocations;
+    uint64_t frees;
+    uint64_t comparisons;
+    uint64_t traversals;
+    uint64_t traversal_steps;
+    uint64_t longest_traversal;
+    uint64_t high_water_size;
+    uint64_t bytes_in_use;
+    uint64_t high_water_bytes;
+};
+
+// The default: nothing is counted
+struct NoStats {
+    static constexpr bool enabled = false;
+
+    void on_alloc() const {}
+    void on_free() const {}
+    void on_compare(size_t) const {}
+    void on_traverse(size_t) const {}
+    void on_size(size_t) const {}
+    void on_memory(size_t) const {}
+};
+
+class CountingStats {
+    private:
+    ContainerStats counts{};
+
+    public:
+    static constexpr bool enabled = true;
+
+    void on_alloc() { ++counts.allocations; }
+
+    void on_free() { ++counts.frees; }
+
+    void on_compare(const size_t n) { counts.comparisons += n; }
+
+    void on_traverse(const size_t steps) {
+        ++counts.traversals;
+        counts.traversal_steps += steps;
+        if (steps > counts.longest_traversal) counts.longest_traversal = steps;
+    }
+
+    void on_size(const size_t size) {
+        if (size > counts.high_water_size) counts.high_water_size = size;
+    }
+
+    void on_memory(const size_t bytes) {
+        if (bytes > counts.high_water_bytes) counts.high_water_bytes = bytes;
+    }
+
+    [[nodiscard]] ContainerStats snapshot(const size_t bytes) const {
+        ContainerStats res = counts;
+        res.bytes_in_use = bytes;
+        if (bytes > res.high_water_bytes) res.high_water_bytes = bytes;
+        return res;
+    }
+
+    // Counters start over, high-water marks from the current state
+    void reset(const size_t size, const size_t bytes) {
+        counts = ContainerStats{};
+        counts.high_water_size = size;
+        counts.high_water_bytes = bytes;
+    }
+};
+
+// Containers built with a counting policy
+template<typename C>
+concept CountsStats = requires(const C& c) {
+    { c.stats() } -> std::same_as<ContainerStats>;
+};
+
+#endif //STATS_H
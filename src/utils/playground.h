@@ -4,13 +4,22 @@
 
 #ifndef PLAYGROUND_H
 #define PLAYGROUND_H
+#include <charconv>
+#include <chrono>
+#include <cstdint>
 #include <functional>
+#include <iomanip>
 #include <iostream>
 #include <sstream>
-#include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
+#include <variant>
 
+#include "io/dump_writer.h"
 #include "priority_q/priority_q.h"
 #include "queue/queue.h"
 #include "stack/stack.h"
@@ -27,33 +36,38 @@ namespace Playground {
     template<typename E>
     class ContainerWrapper {
     private:
-        unique_ptr<Stack<E> > stack_;
-        unique_ptr<Queue<E> > queue_;
-        unique_ptr<PriorityQueue<E> > priority_queue_;
-        ContainerType type_{};
+        // Alternatives follow ContainerType order
+        using Storage = variant<Stack<E>, Queue<E>, PriorityQueue<E> >;
+
+        Storage container_;
         string name_;
 
-    public:
-        explicit ContainerWrapper(const ContainerType type, string name) : type_(type),
-            name_(std::move(name)) {
+        static Storage make_container(const ContainerType type) {
             switch (type) {
-                case ContainerType::STACK:
-                    stack_ = make_unique<Stack<E>>();
-                    break;
-                case ContainerType::QUEUE:
-                    queue_ = make_unique<Queue<E>>();
-                    break;
-                case ContainerType::PRIORITY_QUEUE:
-                    priority_queue_ = make_unique<PriorityQueue<E>>();
-                    break;
+                case ContainerType::STACK: return Storage(in_place_index<0>);
+                case ContainerType::QUEUE: return Storage(in_place_index<1>);
+                case ContainerType::PRIORITY_QUEUE: return Storage(in_place_index<2>);
             }
+            throw runtime_error("Invalid container type");
+        }
+
+        Stack<E> &stack() { return *get_if<Stack<E> >(&container_); }
+        Queue<E> &queue() { return *get_if<Queue<E> >(&container_); }
+        PriorityQueue<E> &priority_queue() { return *get_if<PriorityQueue<E> >(&container_); }
+        const Stack<E> &stack() const { return *get_if<Stack<E> >(&container_); }
+        const Queue<E> &queue() const { return *get_if<Queue<E> >(&container_); }
+        const PriorityQueue<E> &priority_queue() const { return *get_if<PriorityQueue<E> >(&container_); }
+
+    public:
+        explicit ContainerWrapper(const ContainerType type, string name) : container_(make_container(type)),
+            name_(std::move(name)) {
         }
 
-        [[nodiscard]] ContainerType get_type() const { return type_; }
+        [[nodiscard]] ContainerType get_type() const { return static_cast<ContainerType>(container_.index()); }
         [[nodiscard]] const string &get_name() const { return name_; }
 
         [[nodiscard]] const char *get_type_name() const {
-            switch (type_) {
+            switch (get_type()) {
                 case ContainerType::STACK: return "stack";
                 case ContainerType::QUEUE: return "queue";
                 case ContainerType::PRIORITY_QUEUE: return "priority_queue";
@@ -62,260 +76,423 @@ namespace Playground {
         }
 
         void push(const E &e, int prior = 1) {
-            switch (type_) {
-                case ContainerType::STACK: stack_->push(e);
+            switch (get_type()) {
+                case ContainerType::STACK: stack().push(e);
                     break;
-                case ContainerType::QUEUE: queue_->push(e);
+                case ContainerType::QUEUE: queue().push(e);
                     break;
-                case ContainerType::PRIORITY_QUEUE: priority_queue_->push(e, prior);
+                case ContainerType::PRIORITY_QUEUE: priority_queue().push(e, prior);
                     break;
             }
         }
 
         E pop() {
-            switch (type_) {
-                case ContainerType::STACK: return stack_->pop();
-                case ContainerType::QUEUE: return queue_->pop();
-                case ContainerType::PRIORITY_QUEUE: return priority_queue_->pop();
+            switch (get_type()) {
+                case ContainerType::STACK: return stack().pop();
+                case ContainerType::QUEUE: return queue().pop();
+                case ContainerType::PRIORITY_QUEUE: return priority_queue().pop();
             }
             throw runtime_error("Invalid container type");
         }
 
         E head() {
-            switch (type_) {
-                case ContainerType::STACK: return stack_->peek();
-                case ContainerType::QUEUE: return queue_->peek_head();
-                case ContainerType::PRIORITY_QUEUE: return priority_queue_->top();
+            switch (get_type()) {
+                case ContainerType::STACK: return stack().peek();
+                case ContainerType::QUEUE: return queue().peek_head();
+                case ContainerType::PRIORITY_QUEUE: return priority_queue().top();
             }
             throw runtime_error("Invalid container type");
         }
 
         [[nodiscard]] int top_priority() const {
 
-            return type_ == ContainerType::PRIORITY_QUEUE ? priority_queue_->top_priority() : 0;
+            return get_type() == ContainerType::PRIORITY_QUEUE ? priority_queue().top_priority() : 0;
         }
 
         [[nodiscard]] size_t size() const {
-            switch (type_) {
-                case ContainerType::STACK: return stack_->get_size();
-                case ContainerType::QUEUE: return queue_->get_size();
-                case ContainerType::PRIORITY_QUEUE: return priority_queue_->get_size();
+            switch (get_type()) {
+                case ContainerType::STACK: return stack().get_size();
+                case ContainerType::QUEUE: return queue().get_size();
+                case ContainerType::PRIORITY_QUEUE: return priority_queue().get_size();
             }
             return 0;
         }
 
         [[nodiscard]] bool empty() const {
-            switch (type_) {
-                case ContainerType::STACK: return stack_->is_empty();
-                case ContainerType::QUEUE: return queue_->is_empty();
-                case ContainerType::PRIORITY_QUEUE: return priority_queue_->is_empty();
+            switch (get_type()) {
+                case ContainerType::STACK: return stack().is_empty();
+                case ContainerType::QUEUE: return queue().is_empty();
+                case ContainerType::PRIORITY_QUEUE: return priority_queue().is_empty();
             }
             return true;
         }
 
+        void dump(DumpWriter &out, const size_t limit) const {
+            switch (get_type()) {
+                case ContainerType::STACK: stack().dump(out, limit);
+                    break;
+                case ContainerType::QUEUE: queue().dump(out, limit);
+                    break;
+                case ContainerType::PRIORITY_QUEUE: priority_queue().dump(out, limit);
+                    break;
+            }
+        }
+
         [[nodiscard]] E find_by_priority(const int &prior) const {
-            if (type_ != ContainerType::PRIORITY_QUEUE) throw runtime_error("Invalid container type");
-            return priority_queue_->find_by_priority(prior);
+            if (get_type() != ContainerType::PRIORITY_QUEUE) throw runtime_error("Invalid container type");
+            return priority_queue().find_by_priority(prior);
         }
 
         [[nodiscard]] int find_by_value(const int &value) const {
-            if (type_ != ContainerType::PRIORITY_QUEUE) throw runtime_error("Invalid container type");
-            return priority_queue_->find_by_value(value);
+            if (get_type() != ContainerType::PRIORITY_QUEUE) throw runtime_error("Invalid container type");
+            return priority_queue().find_by_value(value);
+        }
+    };
+
+    // === Command line parsing ===
+    // Words of one line as views into it, nothing is copied
+    class Tokenizer {
+    private:
+        string_view rest_;
+
+        static constexpr bool is_blank(const char c) {
+            return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+        }
+
+    public:
+        explicit Tokenizer(const string_view line) : rest_(line) {
+        }
+
+        // Next word, empty once the line is used up
+        string_view next() {
+            size_t begin = 0;
+            while (begin < rest_.size() && is_blank(rest_[begin])) ++begin;
+            size_t end = begin;
+            while (end < rest_.size() && !is_blank(rest_[end])) ++end;
+            const string_view word = rest_.substr(begin, end - begin);
+            rest_.remove_prefix(end);
+            return word;
+        }
+    };
+
+    // The whole word must be a number
+    template<typename T>
+    bool parse_number(const string_view word, T &out) {
+        const auto [end, ec] = from_chars(word.data(), word.data() + word.size(), out);
+        return ec == errc() && end == word.data() + word.size() && !word.empty();
+    }
+
+    template<typename E>
+    bool parse_value(const string_view word, E &out) {
+        if (word.empty()) return false;
+        if constexpr (is_same_v<E, string>) {
+            out.assign(word);
+            return true;
+        } else if constexpr (is_arithmetic_v<E>) {
+            return parse_number(word, out);
+        } else {
+            istringstream iss{string(word)};
+            return static_cast<bool>(iss >> out);
+        }
+    }
+
+    enum class Command {
+        CREATE,
+        USE,
+        REMOVE,
+        PUSH,
+        POP,
+        SIZE,
+        EMPTY,
+        LIST,
+        HEAD,
+        DUMP,
+        HELP,
+        EXIT,
+        UNKNOWN
+    };
+
+    // FNV-1a. Case labels below are hashed at compile time,
+    // two command names with the same hash would not compile
+    constexpr uint32_t command_hash(const string_view word) {
+        uint32_t hash = 2166136261u;
+        for (const char c : word) hash = (hash ^ static_cast<unsigned char>(c)) * 16777619u;
+        return hash;
+    }
+
+    constexpr Command to_command(const string_view word) {
+        switch (command_hash(word)) {
+            case command_hash("create"): return word == "create" ? Command::CREATE : Command::UNKNOWN;
+            case command_hash("use"): return word == "use" ? Command::USE : Command::UNKNOWN;
+            case command_hash("remove"): return word == "remove" ? Command::REMOVE : Command::UNKNOWN;
+            case command_hash("push"): return word == "push" ? Command::PUSH : Command::UNKNOWN;
+            case command_hash("pop"): return word == "pop" ? Command::POP : Command::UNKNOWN;
+            case command_hash("size"): return word == "size" ? Command::SIZE : Command::UNKNOWN;
+            case command_hash("empty"): return word == "empty" ? Command::EMPTY : Command::UNKNOWN;
+            case command_hash("list"): return word == "list" ? Command::LIST : Command::UNKNOWN;
+            case command_hash("head"): return word == "head" ? Command::HEAD : Command::UNKNOWN;
+            case command_hash("dump"): return word == "dump" ? Command::DUMP : Command::UNKNOWN;
+            case command_hash("help"): return word == "help" ? Command::HELP : Command::UNKNOWN;
+            case command_hash("exit"): return word == "exit" ? Command::EXIT : Command::UNKNOWN;
+            default: return Command::UNKNOWN;
         }
+    }
+
+    static_assert(to_command("push") == Command::PUSH && to_command("pusx") == Command::UNKNOWN);
+
+    // Lets containers_ be searched with a string_view
+    struct NameHash {
+        using is_transparent = void;
+
+        size_t operator()(const string_view name) const { return hash<string_view>{}(name); }
     };
 
     template<typename E>
     class PlaygroundManager {
     private:
-        unordered_map<string, unique_ptr<ContainerWrapper<E> > > containers_;
-        unordered_map<string, function<void(istringstream &)> > commands_ = {
-            {
-                "create", [this](auto &iss) {
-                    string type;
-                    if (!(iss >> type)) throw runtime_error("Invalid container type");
-                    handle_create(type);
-                }
-            },
-            {
-                "use", [this](auto &iss) {
-                    string name;
-                    if (!(iss >> name)) throw runtime_error("Invalid container name");
-                    handle_use(name);
-                }
-            },
-            {
-                "remove", [this](auto &iss) {
-                    string name;
-                    if (!(iss >> name)) throw runtime_error("Invalid container name");
-                    handle_remove(name);
-                }
-            },
-            {
-                "push", [this](auto &iss) {
-                    E value;
-                    int prior = 1;
-                    if (!(iss >> value)) throw runtime_error("Invalid value");
-                    iss >> prior;
-                    handle_push(value, prior);
-                }
-            },
-            {"pop", [this](auto &iss) { handle_pop(); }},
-            {"size", [this](auto &iss) { handle_size(); }},
-            {"empty", [this](auto &iss) { handle_empty(); }},
-            {"list", [this](auto &iss) { handle_list(); }},
-            {"head", [this](auto &iss) { handle_head(); }},
-            {"help", [this](auto &iss) { handle_help(); }}
-        };
-        string currentContainer_;
+        unordered_map<string, ContainerWrapper<E>, NameHash, equal_to<> > containers_;
+        // Nodes of containers_ never move, so the current one is kept by address
+        ContainerWrapper<E> *current_ = nullptr;
         int containerCounter_ = 0;
+        size_t errors_ = 0;
+        // All output goes through one buffer, flushed before reading the next command.
+        // Quiet batch runs write to a stream without a buffer, which drops everything
+        ostream nowhere_{nullptr};
+        DumpWriter out_;
 
         // === Util methods for handling containers ===
-        ContainerType string_to_type(const string &str_type) {
+        ContainerType string_to_type(const string_view str_type) {
             if (str_type == "stack") return ContainerType::STACK;
             if (str_type == "queue") return ContainerType::QUEUE;
             if (str_type == "priority_queue") return ContainerType::PRIORITY_QUEUE;
             throw runtime_error("Invalid container type");
         }
 
-        string generate_container_name(const string &type) {
-            return type + "_" + to_string(++containerCounter_);
+        string generate_container_name(const string_view type) {
+            return string(type) + "_" + to_string(++containerCounter_);
         }
 
-        ContainerWrapper<E> *get_current_container() const {
-            auto it = containers_.find(currentContainer_);
-            if (it == containers_.end()) throw runtime_error("No container selected! Use 'use <name>' first.");
-            return it->second.get();
+        ContainerWrapper<E> *get_current_container() {
+            if (current_ == nullptr) throw runtime_error("No container selected! Use 'use <name>' first.");
+            return current_;
         }
 
         // === Util methods to handle commands ===
-        void handle_create(const string &str_type) {
+        void handle_create(const string_view str_type) {
             try {
                 ContainerType type = string_to_type(str_type);
                 string name = generate_container_name(str_type);
-                containers_[name] = make_unique<ContainerWrapper<E> >(type, name);
-                currentContainer_ = name;
-                cout << "Created " << str_type << " '" << name << endl;
-                cout << "Now using: " << name << endl;
+                current_ = &containers_.insert_or_assign(name, ContainerWrapper<E>(type, name)).first->second;
+                out_ << "Created " << str_type << " '" << name << '\n';
+                out_ << "Now using: " << name << '\n';
             } catch (const exception &e) {
-                cout << "Error: " << e.what() << endl;
-                cout << "Available types: stack, queue, priority_queue" << endl;
+                ++errors_;
+                out_ << "Error: " << e.what() << '\n';
+                out_ << "Available types: stack, queue, priority_queue\n";
             }
         }
 
-        void handle_use(const string &name) {
-            if (containers_.contains(name)) {
-                currentContainer_ = name;
-                auto container = get_current_container();
-                cout << "Now using: " << name << " (" << container->get_type_name() << ")" << endl;
+        void handle_use(const string_view name) {
+            if (auto it = containers_.find(name); it != containers_.end()) {
+                current_ = &it->second;
+                out_ << "Now using: " << name << " (" << current_->get_type_name() << ")\n";
             } else {
-                cout << "Error: Container '" << name << "' not found!" << endl;
+                ++errors_;
+                out_ << "Error: Container '" << name << "' not found!\n";
             }
         }
 
         void handle_list() {
             if (containers_.empty()) {
-                cout << "No container created!" << endl;
+                out_ << "No container created!\n";
                 return;
             }
 
-            cout << "Available containers:" << endl;
+            out_ << "Available containers:\n";
             for (const auto &[name, container]: containers_) {
-                cout << " " << name << " (" << container->get_type_name() << ")" << endl;
-                if (name == currentContainer_) cout << " [CURRENT]";
-                cout << " - size: " << container->size();
-                cout << " - empty: " << (container->empty() ? "yes" : "no");
-                cout << endl;
+                out_ << " " << name << " (" << container.get_type_name() << ")\n";
+                if (&container == current_) out_ << " [CURRENT]";
+                out_ << " - size: " << container.size();
+                out_ << " - empty: " << (container.empty() ? "yes" : "no") << '\n';
             }
         }
 
         void handle_push(const E &e, int priority) {
             auto container = get_current_container();
             container->push(e, priority);
-            cout << "Pushed: " << e;
-            if (container->get_type() == ContainerType::PRIORITY_QUEUE) cout << " with priority " << priority;
-            cout << endl;
+            out_ << "Pushed: " << e;
+            if (container->get_type() == ContainerType::PRIORITY_QUEUE) out_ << " with priority " << priority;
+            out_ << '\n';
         }
 
         void handle_pop() {
             auto container = get_current_container();
             E value = container->pop();
-            cout << "Popped: " << value << endl;
+            out_ << "Popped: " << value << '\n';
         }
 
         void handle_head() {
             auto container = get_current_container();
             E value = container->head();
-            cout << "Head: " << value;
-            if (container->get_type() == ContainerType::PRIORITY_QUEUE) cout << " (Priority: " << container->top_priority() << ")";
-            cout << endl;
+            out_ << "Head: " << value;
+            if (container->get_type() == ContainerType::PRIORITY_QUEUE) out_ << " (Priority: " << container->top_priority() << ")";
+            out_ << '\n';
         }
 
         void handle_size() {
             auto container = get_current_container();
-            cout << "Size: " << container->size() << endl;
+            out_ << "Size: " << container->size() << '\n';
         }
 
         void handle_empty() {
             auto container = get_current_container();
-            cout << (container->empty() ? "empty" : "not empty") << endl;
+            out_ << (container->empty() ? "empty" : "not empty") << '\n';
+        }
+
+        void handle_dump(const size_t limit) {
+            auto container = get_current_container();
+            out_ << "Contents: ";
+            container->dump(out_, limit);
+            out_ << '\n';
         }
 
-        void handle_remove(const string &name) {
-            if (containers_.contains(name)) {
-                if (currentContainer_ == name) currentContainer_.clear();
-                containers_.erase(name);
-                cout << "Removed: " << name << endl;
-            } else cout << "Error: Container '" << name << "' not found!" << endl;
+        void handle_remove(const string_view name) {
+            if (auto it = containers_.find(name); it != containers_.end()) {
+                if (&it->second == current_) current_ = nullptr;
+                containers_.erase(it);
+                out_ << "Removed: " << name << '\n';
+            } else {
+                ++errors_;
+                out_ << "Error: Container '" << name << "' not found!\n";
+            }
         }
 
         void handle_help() {
-            cout << "\n=== Available Commands ===\n";
-            cout << "create <type>            - Create container\n";
-            cout << "use <name>               - Switch to container\n";
-            cout << "push <value> [priority]  - Push value\n";
-            cout << "pop                      - Pop element\n";
-            cout << "head                     - View top element\n";
-            cout << "size                     - Get size\n";
-            cout << "empty                    - Check if empty\n";
-            cout << "remove <name>            - Remove container\n";
-            cout << "help                     - Show help\n";
-            cout << "exit                     - Exit playground\n";
-            cout << "==========================\n";
+            out_ << "\n=== Available Commands ===\n";
+            out_ << "create <type>            - Create container\n";
+            out_ << "use <name>               - Switch to container\n";
+            out_ << "push <value> [priority]  - Push value\n";
+            out_ << "pop                      - Pop element\n";
+            out_ << "head                     - View top element\n";
+            out_ << "size                     - Get size\n";
+            out_ << "empty                    - Check if empty\n";
+            out_ << "dump [limit]             - Print elements in pop order\n";
+            out_ << "remove <name>            - Remove container\n";
+            out_ << "help                     - Show help\n";
+            out_ << "exit                     - Exit playground\n";
+            out_ << "==========================\n";
+        }
+
+        // Run one command line, false once it asks to exit
+        bool execute(const string_view command) {
+            Tokenizer words(command);
+            const string_view action = words.next();
+            if (action.empty()) return true;
+
+            try {
+                switch (to_command(action)) {
+                    case Command::CREATE: {
+                        const string_view type = words.next();
+                        if (type.empty()) throw runtime_error("Invalid container type");
+                        handle_create(type);
+                        break;
+                    }
+                    case Command::USE: {
+                        const string_view name = words.next();
+                        if (name.empty()) throw runtime_error("Invalid container name");
+                        handle_use(name);
+                        break;
+                    }
+                    case Command::REMOVE: {
+                        const string_view name = words.next();
+                        if (name.empty()) throw runtime_error("Invalid container name");
+                        handle_remove(name);
+                        break;
+                    }
+                    case Command::PUSH: {
+                        E value{};
+                        if (!parse_value(words.next(), value)) throw runtime_error("Invalid value");
+                        int prior = 1;
+                        const string_view priority = words.next();
+                        if (!priority.empty() && !parse_number(priority, prior)) throw runtime_error("Invalid priority");
+                        handle_push(value, prior);
+                        break;
+                    }
+                    case Command::POP: handle_pop();
+                        break;
+                    case Command::SIZE: handle_size();
+                        break;
+                    case Command::EMPTY: handle_empty();
+                        break;
+                    case Command::LIST: handle_list();
+                        break;
+                    case Command::HEAD: handle_head();
+                        break;
+                    case Command::DUMP: {
+                        size_t limit = DumpWriter::no_limit;
+                        const string_view word = words.next();
+                        if (!word.empty() && !parse_number(word, limit)) throw runtime_error("Invalid limit");
+                        handle_dump(limit);
+                        break;
+                    }
+                    case Command::HELP: handle_help();
+                        break;
+                    case Command::EXIT: out_ << "Exiting Playground...\n";
+                        return false;
+                    case Command::UNKNOWN: ++errors_;
+                        out_ << "Unknown command: '" << action << "'. Type 'help' for available commands.\n";
+                        break;
+                }
+            } catch (const exception &e) {
+                ++errors_;
+                out_ << "Error: " << e.what() << '\n';
+            } catch (...) {
+                ++errors_;
+                out_ << "Unknown error occurred\n";
+            }
+            return true;
         }
 
     public:
+        // quiet drops all command output, meant for batch runs
+        explicit PlaygroundManager(const bool quiet = false) : out_(quiet ? nowhere_ : cout) {
+        }
+
         void run() {
-            cout << "\n=== Playground Mode ===\n";
-            cout << "Type 'help' for commands\n";
+            out_ << "\n=== Playground Mode ===\n";
+            out_ << "Type 'help' for commands\n";
 
             string command;
             while (true) {
-                cout << "playground> ";
+                out_ << "playground> ";
+                out_.flush();
                 if (!getline(cin, command)) break;
 
-                if (command.empty()) continue;
+                if (!execute(command)) break;
+            }
+            out_.flush();
+        }
 
-                istringstream iss(command);
-                string action;
-                iss >> action;
+        // Commands that failed so far, every "Error:" line counts
+        [[nodiscard]] size_t get_errors() const { return errors_; }
 
-                if (action == "exit") {
-                    cout << "Exiting Playground..." << endl;
-                    break;
-                }
-
-                try {
-                    if (auto it = commands_.find(action); it != commands_.end()) {
-                        it->second(iss);
-                    } else {
-                        cout << "Unknown command: '" << action << "'. Type 'help' for available commands." << endl;
-                    }
-                } catch (const exception &e) {
-                    cout << "Error: " << e.what() << endl;
-                } catch (...) {
-                    cout << "Unknown error occurred" << endl;
-                }
+        // Batch mode: commands from in until EOF or 'exit', no prompts,
+        // output leaves in full buffers. Lines starting with '#' are comments.
+        // The ops/sec summary goes to cerr, so stdout keeps only command output
+        void run_batch(istream &in) {
+            size_t executed = 0;
+            string command;
+            const auto start = chrono::steady_clock::now();
+            while (getline(in, command)) {
+                if (command.empty() || command[0] == '#') continue;
+                ++executed;
+                if (!execute(command)) break;
             }
+            out_.flush();
+            const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            const auto rate = static_cast<long long>(seconds > 0 ? static_cast<double>(executed) / seconds : 0.0);
+            cerr << "=== Batch: " << executed << " commands in " << fixed << setprecision(3) << seconds << " s, "
+                    << rate << " ops/sec, " << errors_ << " errors ===" << endl;
         }
     };
 }
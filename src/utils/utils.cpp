@@ -4,6 +4,7 @@
 
 #include "utils.h"
 
+#include <fstream>
 #include <iostream>
 #include <limits>
 
@@ -94,4 +95,36 @@ namespace Utils {
         }
     }
 
+    template<typename E>
+    void run_batch(std::istream &in, const bool quiet) {
+        Playground::PlaygroundManager<E> playground(quiet);
+        playground.run_batch(in);
+    }
+
+    // Playground commands from a file, or stdin for "-", without the menu
+    int run_batch_mode(const std::string &path, const std::string &type, const bool quiet) {
+        std::ifstream file;
+        std::istream *in = &std::cin;
+        if (path == "-") {
+            std::ios::sync_with_stdio(false);
+            std::cin.tie(nullptr);
+        } else {
+            file.open(path);
+            if (!file) {
+                std::cerr << "Cannot open command file '" << path << "'" << std::endl;
+                return 1;
+            }
+            in = &file;
+        }
+
+        if (type == "int") run_batch<int>(*in, quiet);
+        else if (type == "double") run_batch<double>(*in, quiet);
+        else if (type == "string") run_batch<std::string>(*in, quiet);
+        else {
+            std::cerr << "Unsupported type '" << type << "', expected int, double or string" << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
 }
@@ -14,6 +14,7 @@ namespace Utils {
     bool get_confirm(const std::string& msg);
     void run_free_mode();
     void run_playground_mode();
+    int run_batch_mode(const std::string& path, const std::string& type, bool quiet);
 }
 
 #endif //UTILS_H
\ No newline at end of file
@@ -0,0 +1,53 @@
+#include <cassert>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "test_utils.h"
+#include "utils/playground.h"
+
+namespace {
+    // Run a script in quiet batch mode, returns what it reported on cerr
+    template<typename E>
+    std::string run_script(const std::string& script, size_t& errors) {
+        Playground::PlaygroundManager<E> playground(true);
+        std::istringstream in(script);
+        std::ostringstream summary;
+        std::streambuf* saved = std::cerr.rdbuf(summary.rdbuf());
+        playground.run_batch(in);
+        std::cerr.rdbuf(saved);
+        errors = playground.get_errors();
+        return summary.str();
+    }
+}
+
+void run_tests_playground() {
+    std::cout << "=== Running Playground Tests ===" << std::endl;
+
+    // Test 1: Clean script, comments are skipped and nothing after exit runs
+    std::cout << "Test 1: Batch without errors... ";
+    size_t errors = 0;
+    std::string summary = run_script<int>("# comment\ncreate queue\npush 1\npush 2\npop\nsize\nexit\npop\n", errors);
+    assert(errors == 0);
+    assert(summary.find("6 commands") != std::string::npos);
+    assert(summary.find(", 0 errors") != std::string::npos);
+    std::cout << "PASSED" << std::endl;
+
+    // Test 2: Every failing line is counted, whichever handler reports it
+    std::cout << "Test 2: Batch error count... ";
+    summary = run_script<int>("create heap\n"    // Unknown type
+                              "use nothing\n"    // Unknown container
+                              "pop\n"            // No container selected
+                              "create stack\n"
+                              "push x\n"         // Not an int
+                              "remove nothing\n" // Unknown container
+                              "frobnicate\n"     // Unknown command
+                              "pop\n"            // Empty stack
+                              "push 3\n",
+                              errors);
+    assert(errors == 7);
+    assert(summary.find("9 commands") != std::string::npos);
+    assert(summary.find(", 7 errors") != std::string::npos);
+    std::cout << "PASSED" << std::endl;
+
+    std::cout << "\n=== All Playground tests PASSED! ===" << std::endl;
+}
@@ -0,0 +1,6 @@
+#ifndef TEST_UTILS_H
+#define TEST_UTILS_H
+
+void run_tests_playground();
+
+#endif //TEST_UTILS_H